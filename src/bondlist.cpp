@@ -0,0 +1,162 @@
+// bondlist.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              FENE bonds between polymer beads
+//              bondlist.cpp
+//----------------------------------------------------------------------------------------
+
+#include <iostream>
+
+#include <cstdlib>
+#include <cmath>
+
+// ***** localincludes *****
+#include "glbcls.h"
+#include "glbfunc.h"
+#include "bondlist.h"
+#include "initiation.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+BondList::BondList(ParticleStore &particles, Initiation &ini):
+store(&particles), polymer_H(ini.polymer_H), polymer_r0(ini.polymer_r0), period(0.0),
+capacity(0), bond_force(0), number_of_bonds(0), bond_i(0), bond_j(0)
+{
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+BondList::~BondList()
+{
+    delete[] bond_i; delete[] bond_j; delete[] bond_force;
+}
+//----------------------------------------------------------------------------------------
+//                      find the bonds from the polymer IDs of the real particles
+//----------------------------------------------------------------------------------------
+void BondList::Build(const Vec2d &period)
+{
+    int n;
+    long id;
+
+    this->period = period;
+    number_of_bonds = 0;
+
+    //the polymer IDs are only connected if the FENE force is given
+    if(polymer_r0 <= 0.0) return;
+
+    //the largest polymer ID
+    long id_max = 0;
+    for(n = 0; n < store->number_of_real; n++)
+        if(store->polyID[n] > id_max) id_max = store->polyID[n];
+
+    //the bead with each polymer ID, -1: none
+    int *bead = new int[id_max + 2];
+    for(id = 0; id < id_max + 2; id++) bead[id] = -1;
+    for(n = 0; n < store->number_of_real; n++) {
+        id = store->polyID[n];
+        if(id <= 0) continue;
+        if(bead[id] != -1) {
+            cout<<"BondList: the polymer ID "<<id<<" is given to two particles! \n";
+            std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+            exit(1);
+        }
+        bead[id] = n;
+    }
+
+    //a bead is bonded to the bead with the next polymer ID
+    for(id = 1; id <= id_max; id++)
+        if(bead[id] != -1 && bead[id + 1] != -1) number_of_bonds++;
+
+    if(number_of_bonds > capacity) {
+        delete[] bond_i; delete[] bond_j; delete[] bond_force;
+        capacity = number_of_bonds;
+        bond_i = new int[capacity];
+        bond_j = new int[capacity];
+        bond_force = new Vec2d[capacity];
+    }
+
+    n = 0;
+    for(id = 1; id <= id_max; id++)
+        if(bead[id] != -1 && bead[id + 1] != -1) {
+            bond_i[n] = bead[id];
+            bond_j[n] = bead[id + 1];
+            n++;
+        }
+    delete[] bead;
+
+    if(number_of_bonds > 0) cout<<"BondList: "<<number_of_bonds<<" FENE bonds between the polymer beads \n";
+}
+//----------------------------------------------------------------------------------------
+//                      add the bond forces to the accelerations of the bonded particles
+//----------------------------------------------------------------------------------------
+void BondList::BondForces(Vec2d *dUdt)
+{
+    int k;
+    const double rr02 = 1.0/(polymer_r0*polymer_r0);
+    //largest squared bond length relative to polymer_r0
+    double relR2_max = 0.0;
+
+    //the forces of all bonds, each bond only depends on its own particles
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max:relR2_max)
+#endif
+    for(k = 0; k < number_of_bonds; k++) {
+        const Vec2d Rij = Wrap(store->R[bond_i[k]] - store->R[bond_j[k]]);
+        const double relR2 = v_sq(Rij)*rr02;
+        relR2_max = relR2 > relR2_max ? relR2 : relR2_max;
+        bond_force[k] = Rij*(polymer_H/(1.0 - relR2));
+    }
+
+    if(relR2_max > 1.0)
+        for(k = 0; k < number_of_bonds; k++)
+            if(v_sq(Wrap(store->R[bond_i[k]] - store->R[bond_j[k]]))*rr02 > 1.0) Broken(k);
+
+    //summation in the bond order
+    for(k = 0; k < number_of_bonds; k++) {
+        dUdt[bond_i[k]] -= bond_force[k]*(1.0/store->m[bond_i[k]]);
+        dUdt[bond_j[k]] += bond_force[k]*(1.0/store->m[bond_j[k]]);
+    }
+}
+//----------------------------------------------------------------------------------------
+//                              xy virial of the bond forces
+//----------------------------------------------------------------------------------------
+double BondList::ShearVirial() const
+{
+    double virial = 0.0;
+    if(number_of_bonds == 0) return virial;
+    const double rr02 = 1.0/(polymer_r0*polymer_r0);
+
+    //the force on bond_i[k] is - bond_force[k] at the current positions
+    for(int k = 0; k < number_of_bonds; k++) {
+        const Vec2d Rij = Wrap(store->R[bond_i[k]] - store->R[bond_j[k]]);
+        virial -= Rij[0]*Rij[1]*polymer_H/(1.0 - v_sq(Rij)*rr02);
+    }
+    return virial;
+}
+//----------------------------------------------------------------------------------------
+//                      stop the simulation on a bond longer than polymer_r0
+//----------------------------------------------------------------------------------------
+void BondList::Broken(int k) const
+{
+    extern double k_bltz;
+    const int i = bond_i[k], j = bond_j[k];
+    const double rij = v_abs(Wrap(store->R[i] - store->R[j]));
+
+    std::cerr << __FILE__ << ':' << __LINE__ << ": ERROR: polymer is broken\n" ;
+    std::cerr << "rij  = " << rij << std::endl;
+    std::cerr << "period:  " << period << std::endl;
+    std::cerr << "polymer_r0  = " << polymer_r0 << std::endl;
+    std::cerr << "polymer_H  = " << polymer_H << std::endl;
+    std::cerr << "H*r0^2/kt  = " << polymer_H*polymer_r0*polymer_r0/(k_bltz*store->T[i]) << std::endl;
+    std::cerr << "relR  = " << rij/polymer_r0 << std::endl;
+    std::cerr << "Org->R: " << store->R[i] << std::endl;
+    std::cerr << "Dest->R: " << store->R[j] << std::endl;
+    std::cerr << "Org->polyID: " << store->polyID[i] << std::endl;
+    std::cerr << "Dest->polyID: " << store->polyID[j] << std::endl;
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,62 @@
+/// \file bondlist.h
+/// \brief FENE bonds between polymer beads
+
+#ifndef BONDLIST_H
+#define BONDLIST_H
+
+class Initiation;
+
+/// FENE bonds between polymer beads
+///
+/// Two real particles are bonded if their polymer IDs are positive and differ by one.
+/// The bonds are found once from the polymer IDs and refer to the store indices
+/// of the real particles, which do not change when the particles are sorted into cells.
+/// The bond forces do not depend on the pair list, so a bond may be longer than the
+/// support of the kernel.
+class BondList {
+
+    ///the bonded particles
+    ParticleStore *store;
+    ///FENE force paramters, F = H*r / (1 - (r/r0)^2)
+    double polymer_H, polymer_r0;
+    ///box lengths of the periodic directions for the nearest image of the beads,
+    ///0: not periodic
+    Vec2d period;
+
+    ///length of the bond arrays
+    int capacity;
+    ///force of each bond on its first particle
+    Vec2d *bond_force;
+
+    ///nearest image of a bond vector
+    Vec2d Wrap(Vec2d d) const {
+        for(int i = 0; i < 2; i++)
+            if(period[i] > 0.0) d[i] -= period[i]*floor(d[i]/period[i] + 0.5);
+        return d;
+    }
+    ///stop the simulation on a bond longer than polymer_r0
+    void Broken(int k) const;
+
+public:
+
+    ///number of bonds
+    int number_of_bonds;
+    ///bonded particles, the polymer ID of bond_j[k] is the one of bond_i[k] plus one
+    int *bond_i, *bond_j;
+
+    ///constructor
+    BondList(ParticleStore &particles, Initiation &ini);
+    ///destructor
+    ~BondList();
+
+    ///find the bonds from the polymer IDs of the real particles,
+    ///period gives the box lengths of the periodic directions
+    void Build(const Vec2d &period);
+    ///add the bond forces to the acceleration of the bonded particles
+    void BondForces() { BondForces(store->dUdt); }
+    ///add the bond forces to the accelerations dUdt of the real particles
+    void BondForces(Vec2d *dUdt);
+    ///symmetric xy virial sum(rij*Fij) of the bond forces
+    double ShearVirial() const;
+};
+#endif
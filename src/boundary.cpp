@@ -22,8 +22,9 @@
 #include "boundary.h"
 #include "initiation.h"
 #include "particlemanager.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
-#include "particle.h"
 #include "material.h"
 
 using namespace std;
@@ -37,6 +38,9 @@ Boundary::Boundary(Initiation &ini, Hydrodynamics &hydro, ParticleManager &parti
     box_size = ini.box_size;
     x_clls = particles.x_clls; y_clls = particles.y_clls;
     number_of_materials = ini.number_of_materials;
+    halo_side_length = 1024;
+    halo_side = new int[halo_side_length];
+    halo_split = 0;
 
     //check if inputfile exist
     strcpy(inputfile, ini.inputfile);
@@ -64,11 +68,35 @@ Boundary::Boundary(Initiation &ini, Hydrodynamics &hydro, ParticleManager &parti
     }
     fin.close();
 
+    //periodic directions wrapped by the nearest image instead of ghost particles
+    wrap_x = ini.periodic_wrap == 1 && xBl == 1 && xBr == 1;
+    wrap_y = ini.periodic_wrap == 1 && yBd == 1 && yBu == 1;
+    if(x_clls - 2 < particles.cell_rings || y_clls - 2 < particles.cell_rings) {
+        cout<<"Boundary: at least "<<particles.cell_rings<<" cells are needed in each direction! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    //each pair is found once if the search rings do not overlap around the period
+    if((wrap_x && x_clls < 2*particles.cell_rings + 3) || (wrap_y && y_clls < 2*particles.cell_rings + 3)) {
+        cout<<"Boundary: at least "<<2*particles.cell_rings + 1<<" cells are needed in a wrapped periodic direction! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(wrap_x) particles.store.period[0] = box_size[0];
+    if(wrap_y) particles.store.period[1] = box_size[1];
+
     show_information(ini);      
 
     //build boundary particles
     BuildBoundaryParticles(particles, hydro);
 }
+//----------------------------------------------------------------------------------------
+//                                                      destructor
+//----------------------------------------------------------------------------------------
+Boundary::~Boundary()
+{
+    delete[] halo_side;
+}
 void Boundary::show_information(Initiation &ini)
 {
     //output the property parameters to the screen
@@ -85,101 +113,99 @@ void Boundary::show_information(Initiation &ini)
 //----------------------------------------------------------------------------------------
 void Boundary::RunAwayCheck(Hydrodynamics &hydro)
 {
-    //iterate the partilce list
-    for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-         !hydro.particle_list.isEnd(p); 
-         p = hydro.particle_list.next(p)) {
-                                
-        Particle *prtl = hydro.particle_list.retrieve(p);
+    ParticleStore &store = hydro.store;
 
-        if(ABS(prtl->R[0]) >= 2.0*box_size[0] || ABS(prtl->R[1]) >= 2.0*box_size[1]) {
+    //iterate the real partilces
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
+
+        if(ABS(store.R[prtl][0]) >= 2.0*box_size[0] || ABS(store.R[prtl][1]) >= 2.0*box_size[1]) {
             cout<<"Boundary: the particles run out too far away from the domain! \n";
             std::cout << __FILE__ << ':' << __LINE__ << std::endl;
             exit(1);
         }
         //only checking real particles
-        if(prtl->bd == 0) {
+        if(store.bd[prtl] == 0) {
             //west boundary
-            if(prtl->R[0] < 0.0) {
+            if(store.R[prtl][0] < 0.0) {
                 switch(xBl) {
                     //wall
                 case 0: 
-                    prtl->R[0] = - prtl->R[0]; 
+                    store.R[prtl][0] = - store.R[prtl][0]; 
                     break;
                     //perodic
                 case 1:
-                    prtl->R[0] = box_size[0] + prtl->R[0];
+                    store.R[prtl][0] = box_size[0] + store.R[prtl][0];
                     break;
                     //free slip
                 case 2:
-                    prtl->R[0] = - prtl->R[0]; 
+                    store.R[prtl][0] = - store.R[prtl][0]; 
                     break;
                     //symmetry
                 case 3:
-                    prtl->R[0] = - prtl->R[0]; 
+                    store.R[prtl][0] = - store.R[prtl][0]; 
                     break;
                 }
             }
             //east boundary
-            if(prtl->R[0] > box_size[0]) {
+            if(store.R[prtl][0] > box_size[0]) {
                 switch(xBr) {
                     //wall
                 case 0: 
-                    prtl->R[0] = 2.0*box_size[0] - prtl->R[0]; 
+                    store.R[prtl][0] = 2.0*box_size[0] - store.R[prtl][0]; 
                     break;
                     //perodic
                 case 1:
-                    prtl->R[0] = prtl->R[0] - box_size[0];
+                    store.R[prtl][0] = store.R[prtl][0] - box_size[0];
                     break;
                     //free slip
                 case 2: 
-                    prtl->R[0] = 2.0*box_size[0] - prtl->R[0]; 
+                    store.R[prtl][0] = 2.0*box_size[0] - store.R[prtl][0]; 
                     break;
                     //symmetry
                 case 3:
-                    prtl->R[0] = 2.0*box_size[0] - prtl->R[0]; 
+                    store.R[prtl][0] = 2.0*box_size[0] - store.R[prtl][0]; 
                     break;
                 }
             }
             //south boundary
-            if(prtl->R[1] < 0.0) {
+            if(store.R[prtl][1] < 0.0) {
                 switch(yBd) {
                     //wall
                 case 0: 
-                    prtl->R[1] = - prtl->R[1]; 
+                    store.R[prtl][1] = - store.R[prtl][1]; 
                     break;
                     //perodic
                 case 1:
-                    prtl->R[1] = box_size[1] + prtl->R[1];
+                    store.R[prtl][1] = box_size[1] + store.R[prtl][1];
                     break;
                     //free slip
                 case 2: 
-                    prtl->R[1] = - prtl->R[1]; 
+                    store.R[prtl][1] = - store.R[prtl][1]; 
                     break;
                     //symmetry
                 case 3:
-                    prtl->R[1] = - prtl->R[1]; 
+                    store.R[prtl][1] = - store.R[prtl][1]; 
                     break;
                 }
             }
             //north boundary
-            if(prtl->R[1] > box_size[1]) {
+            if(store.R[prtl][1] > box_size[1]) {
                 switch(yBu) {
                     //wall
                 case 0: 
-                    prtl->R[1] = 2.0*box_size[1] - prtl->R[1]; 
+                    store.R[prtl][1] = 2.0*box_size[1] - store.R[prtl][1]; 
                     break;
                     //perodic
                 case 1:
-                    prtl->R[1] = prtl->R[1] - box_size[1];
+                    store.R[prtl][1] = store.R[prtl][1] - box_size[1];
                     break;
                     //free slip
                 case 2: 
-                    prtl->R[1] = 2.0*box_size[1] - prtl->R[1]; 
+                    store.R[prtl][1] = 2.0*box_size[1] - store.R[prtl][1]; 
                     break;
                     //symmetry
                 case 3:
-                    prtl->R[1] = 2.0*box_size[1] - prtl->R[1]; 
+                    store.R[prtl][1] = 2.0*box_size[1] - store.R[prtl][1]; 
                     break;
                 }
             }
@@ -191,10 +217,16 @@ void Boundary::RunAwayCheck(Hydrodynamics &hydro)
 //----------------------------------------------------------------------------------------
 void Boundary::BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics &hydro)
 {
-    int i, j;
+    int i, j, l;
+
+    ParticleStore &store = particles.store;
+    //the boundary particles are copied from the cell_rings layers of inner cells at each side,
+    //they stay until the next pair search and cover the smoothing length plus the Verlet skin
+    const int cell_rings = particles.cell_rings;
 
-    //clear boundary particles list
-    boundary_particle_list.clear();
+    //clear boundary particles and sort the real particles into cells
+    store.ClearBoundary();
+    particles.SortParticles();
         
     int kb, ku, mb, mu;
     //default: no coner need to be considered
@@ -211,300 +243,212 @@ void Boundary::BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics
     //x direction
     for(j = 1; j < y_clls - 1; j++) {
         //west side
-        //clear cell linked list data (particles)
-        particles.cell_lists[0][j].clear_data();
                 
         //the rigid wall conditions     
         if(xBl == 0 || xBl == 2) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p10 = particles.cell_lists[1][j].first(); 
-                 !particles.cell_lists[1][j].isEnd(p10); 
-                 p10 = particles.cell_lists[1][j].next(p10)) {
+            //iterate the correspeond cell
+            for(l = 0; l < cell_rings; l++) {
+                for(int p10 = particles.CellBegin(1 + l, j); p10 < particles.CellEnd(1 + l, j); p10++) {
                                 
-                //the original real particle
-                Particle *prtl_old = particles.cell_lists[1][j].retrieve(p10);
-                Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
+                    //the original real particle
+                    int prtl = store.AddImage(particles.particle_index[p10], hydro.materials[0]);
 
-                //boundary condition
-                Boundary_W(prtl);
-
-                //in which cell
-                prtl->cell_i = 0; prtl->cell_j = j; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[0][j].insert(particles.cell_lists[0][j].first(), prtl);
+                    //boundary condition
+                    AddHalo(store, prtl, SIDE_W);
+                    //put it into the corresponding cell
+                    particles.AssignCell(prtl, 0, j);
+                }
             }
         }
                 
         //the symmetry conditions       
         if(xBl == 3) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p13 = particles.cell_lists[1][j].first(); 
-                 !particles.cell_lists[1][j].isEnd(p13); 
-                 p13 = particles.cell_lists[1][j].next(p13)) {
+            //iterate the correspeond cell
+            for(l = 0; l < cell_rings; l++) {
+                for(int p13 = particles.CellBegin(1 + l, j); p13 < particles.CellEnd(1 + l, j); p13++) {
                                 
-                //the original real particle
-                Particle *prtl_old = particles.cell_lists[1][j].retrieve(p13);
-                Particle *prtl = new Particle(*prtl_old);
+                    //the original real particle
+                    int prtl = store.AddGhost(particles.particle_index[p13]);
 
-                //boundary condition
-                Boundary_W(prtl);
-
-                //in which cell
-                prtl->cell_i = 0; prtl->cell_j = j; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[0][j].insert(particles.cell_lists[0][j].first(), prtl);
+                    //boundary condition
+                    AddHalo(store, prtl, SIDE_W);
+                    //put it into the corresponding cell
+                    particles.AssignCell(prtl, 0, j);
+                }
             }
         }
 
         //the perodic conditions        
-        if(xBl == 1) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p11 = particles.cell_lists[x_clls - 2][j].first(); 
-                 !particles.cell_lists[x_clls - 2][j].isEnd(p11); 
-                 p11 = particles.cell_lists[x_clls - 2][j].next(p11)) {
+        if(xBl == 1 && !wrap_x) {
+            //iterate the correspeond cell
+            for(l = 0; l < cell_rings; l++) {
+                for(int p11 = particles.CellBegin(x_clls - 2 - l, j); p11 < particles.CellEnd(x_clls - 2 - l, j); p11++) {
                                         
-                //the original real particle
-                Particle *prtl_old = particles.cell_lists[x_clls - 2][j].retrieve(p11);
-                Particle *prtl = new Particle(*prtl_old);
+                    //the original real particle
+                    int prtl = store.AddGhost(particles.particle_index[p11]);
 
-                //boundary condition
-                Boundary_W(prtl);
-                                
-                //in which cell
-                prtl->cell_i = 0; prtl->cell_j = j; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[0][j].insert(particles.cell_lists[0][j].first(), prtl);
+                    //boundary condition
+                    AddHalo(store, prtl, SIDE_W);
+                    //put it into the corresponding cell
+                    particles.AssignCell(prtl, 0, j);
+                }
             }
         }
 
         //east side
-        //clear linked list data (particles)
-        particles.cell_lists[x_clls - 1][j].clear_data();
 
         //the rigid wall conditions     
         if(xBr == 0 || xBr == 2) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p20 = particles.cell_lists[x_clls - 2][j].first(); 
-                 !particles.cell_lists[x_clls - 2][j].isEnd(p20); 
-                 p20 = particles.cell_lists[x_clls - 2][j].next(p20)) {
+            //iterate the correspeond cell
+            for(l = 0; l < cell_rings; l++) {
+                for(int p20 = particles.CellBegin(x_clls - 2 - l, j); p20 < particles.CellEnd(x_clls - 2 - l, j); p20++) {
                                         
-                //the original real particle
-                Particle *prtl_old = particles.cell_lists[x_clls - 2][j].retrieve(p20);
-                Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
+                    //the original real particle
+                    int prtl = store.AddImage(particles.particle_index[p20], hydro.materials[0]);
 
-                //boundary condition
-                Boundary_E(prtl);
-
-                //in which cell
-                prtl->cell_i = x_clls - 1; prtl->cell_j = j; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[x_clls- 1][j].insert(particles.cell_lists[x_clls - 1][j].first(), prtl);
+                    //boundary condition
+                    AddHalo(store, prtl, SIDE_E);
+                    //put it into the corresponding cell
+                    particles.AssignCell(prtl, x_clls- 1, j);
+                }
             }
         }
                 
         //the symmetry conditions       
         if(xBr == 3) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p23 = particles.cell_lists[x_clls - 2][j].first(); 
-                 !particles.cell_lists[x_clls - 2][j].isEnd(p23); 
-                 p23 = particles.cell_lists[x_clls - 2][j].next(p23)) {
+            //iterate the correspeond cell
+            for(l = 0; l < cell_rings; l++) {
+                for(int p23 = particles.CellBegin(x_clls - 2 - l, j); p23 < particles.CellEnd(x_clls - 2 - l, j); p23++) {
                                         
-                //the original real particle
-                Particle *prtl_old = particles.cell_lists[x_clls - 2][j].retrieve(p23);
-                Particle *prtl = new Particle(*prtl_old);
+                    //the original real particle
+                    int prtl = store.AddGhost(particles.particle_index[p23]);
 
-                //boundary condition
-                Boundary_E(prtl);
-
-                //in which cell
-                prtl->cell_i = x_clls - 1; prtl->cell_j = j; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[x_clls- 1][j].insert(particles.cell_lists[x_clls - 1][j].first(), prtl);
+                    //boundary condition
+                    AddHalo(store, prtl, SIDE_E);
+                    //put it into the corresponding cell
+                    particles.AssignCell(prtl, x_clls- 1, j);
+                }
             }
         }
 
         //the perodic conditions        
-        if(xBr == 1) {
+        if(xBr == 1 && !wrap_x) {
             //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p21 = particles.cell_lists[1][j].first(); 
-                 !particles.cell_lists[1][j].isEnd(p21); 
-                 p21 = particles.cell_lists[1][j].next(p21)) {
+            for(l = 0; l < cell_rings; l++) {
+                for(int p21 = particles.CellBegin(1 + l, j); p21 < particles.CellEnd(1 + l, j); p21++) {
                                         
-                //the original real particle
-                Particle *prtl_old = particles.cell_lists[1][j].retrieve(p21);
-                Particle *prtl = new Particle(*prtl_old);
+                    //the original real particle
+                    int prtl = store.AddGhost(particles.particle_index[p21]);
 
-                //boundary condition
-                Boundary_E(prtl);
-
-                //in which cell
-                prtl->cell_i = x_clls - 1; prtl->cell_j = j; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[x_clls- 1][j].insert(particles.cell_lists[x_clls - 1][j].first(), prtl);
+                    //boundary condition
+                    AddHalo(store, prtl, SIDE_E);
+                    //put it into the corresponding cell
+                    particles.AssignCell(prtl, x_clls- 1, j);
+                }
             }
         }
     }
 
     //y direction
+    //the boundary particles from here on may be copied from the west and east boundary particles
+    halo_split = store.number_of_particles;
+    //the west and east boundary particles are needed in the cells
+    particles.SortParticles();
 
     //south side
     for(i = kb; i < mb; i++) {
-        //clear cell linked list data (particles)
-        particles.cell_lists[i][0].clear_data();
 
         //the rigid wall conditions     
         if(yBd == 0 || yBd == 2) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p30 = particles.cell_lists[i][1].first(); 
-                 !particles.cell_lists[i][1].isEnd(p30); 
-                 p30 = particles.cell_lists[i][1].next(p30)) {
+            //iterate the correspeond cell
+            for(int p30 = particles.CellBegin(i, 1); p30 < particles.CellEnd(i, cell_rings); p30++) {
                                         
                 //the original real particle
-                Particle *prtl_old = particles.cell_lists[i][1].retrieve(p30);
-                Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
+                int prtl = store.AddImage(particles.particle_index[p30], hydro.materials[0]);
 
                 //boundary condition
-                Boundary_S(prtl);
-
-                //in which cell
-                prtl->cell_i = i; prtl->cell_j = 0; 
-                //insert its poistion on the image particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[i][0].insert(particles.cell_lists[i][0].first(), prtl);
+                AddHalo(store, prtl, SIDE_S);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, i, 0);
             }
         }
 
         //the symmetry conditions       
         if(yBd == 3) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p33 = particles.cell_lists[i][1].first(); 
-                 !particles.cell_lists[i][1].isEnd(p33); 
-                 p33 = particles.cell_lists[i][1].next(p33)) {
+            //iterate the correspeond cell
+            for(int p33 = particles.CellBegin(i, 1); p33 < particles.CellEnd(i, cell_rings); p33++) {
                                         
                 //the original real particle
-                Particle *prtl_old = particles.cell_lists[i][1].retrieve(p33);
-                Particle *prtl = new Particle(*prtl_old);
+                int prtl = store.AddGhost(particles.particle_index[p33]);
 
                 //boundary condition
-                Boundary_S(prtl);
-
-                //in which cell
-                prtl->cell_i = i; prtl->cell_j = 0; 
-                //insert its poistion on the image particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[i][0].insert(particles.cell_lists[i][0].first(), prtl);
+                AddHalo(store, prtl, SIDE_S);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, i, 0);
             }
         }
 
         //the perodic conditions        
-        if(yBd == 1) {
+        if(yBd == 1 && !wrap_y) {
             //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p31 = particles.cell_lists[i][y_clls - 2].first(); 
-                 !particles.cell_lists[i][y_clls - 2].isEnd(p31); 
-                 p31 = particles.cell_lists[i][y_clls - 2].next(p31)) {
+            for(int p31 = particles.CellBegin(i, y_clls - 1 - cell_rings); p31 < particles.CellEnd(i, y_clls - 2); p31++) {
                                         
                 //the original real particle
-                Particle *prtl_old = particles.cell_lists[i][y_clls - 2].retrieve(p31);
-                Particle *prtl = new Particle(*prtl_old);
+                int prtl = store.AddGhost(particles.particle_index[p31]);
 
                 //boundary condition
-                Boundary_S(prtl);
-
-                //in which cell
-                prtl->cell_i = i; prtl->cell_j = 0; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[i][0].insert(particles.cell_lists[i][0].first(), prtl);
+                AddHalo(store, prtl, SIDE_S);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, i, 0);
             }
         }
     }
 
     //north side
     for(i = ku; i < mu; i++) {
-        //clear the linked list data (particles)
-        particles.cell_lists[i][y_clls - 1].clear_data();
 
         //the rigid wall conditions     
         if(yBu == 0 || yBu == 2) {
             //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p40 = particles.cell_lists[i][y_clls - 2].first(); 
-                 !particles.cell_lists[i][y_clls - 2].isEnd(p40); 
-                 p40 = particles.cell_lists[i][y_clls - 2].next(p40)) {
+            for(int p40 = particles.CellBegin(i, y_clls - 1 - cell_rings); p40 < particles.CellEnd(i, y_clls - 2); p40++) {
                                         
                 //the original real particle
-                Particle *prtl_old = particles.cell_lists[i][y_clls - 2].retrieve(p40);
-                Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
+                int prtl = store.AddImage(particles.particle_index[p40], hydro.materials[0]);
 
                 //boundary condition
-                Boundary_N(prtl);
-
-                //in which cell
-                prtl->cell_i = i; prtl->cell_j = y_clls - 1; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[i][y_clls- 1].insert(particles.cell_lists[i][y_clls - 1].first(), prtl);
+                AddHalo(store, prtl, SIDE_N);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, i, y_clls- 1);
             }
         }
         
         //the symmetry conditions       
         if(yBu == 3) {
             //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p43 = particles.cell_lists[i][y_clls - 2].first(); 
-                 !particles.cell_lists[i][y_clls - 2].isEnd(p43); 
-                 p43 = particles.cell_lists[i][y_clls - 2].next(p43)) {
+            for(int p43 = particles.CellBegin(i, y_clls - 1 - cell_rings); p43 < particles.CellEnd(i, y_clls - 2); p43++) {
                                         
                 //the original real particle
-                Particle *prtl_old = particles.cell_lists[i][y_clls - 2].retrieve(p43);
-                Particle *prtl = new Particle(*prtl_old);
+                int prtl = store.AddGhost(particles.particle_index[p43]);
 
                 //boundary condition
-                Boundary_N(prtl);
-
-                //in which cell
-                prtl->cell_i = i; prtl->cell_j = y_clls - 1; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[i][y_clls- 1].insert(particles.cell_lists[i][y_clls - 1].first(), prtl);
+                AddHalo(store, prtl, SIDE_N);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, i, y_clls- 1);
             }
         }
 
         //the perodic conditions        
-        if(yBu == 1) {
+        if(yBu == 1 && !wrap_y) {
             //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p41 = particles.cell_lists[i][1].first(); 
-                 !particles.cell_lists[i][1].isEnd(p41); 
-                 p41 = particles.cell_lists[i][1].next(p41)) {
+            for(int p41 = particles.CellBegin(i, 1); p41 < particles.CellEnd(i, cell_rings); p41++) {
                                         
                 //the original real particle
-                Particle *prtl_old = particles.cell_lists[i][1].retrieve(p41);
-                Particle *prtl = new Particle(*prtl_old);
+                int prtl = store.AddGhost(particles.particle_index[p41]);
 
                 //boundary condition
-                Boundary_N(prtl);
-
-                //in which cell
-                prtl->cell_i = i; prtl->cell_j = y_clls - 1; 
-                //insert its poistion on the particle list
-                boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-                //insert the position into corresponding cell list
-                particles.cell_lists[i][y_clls- 1].insert(particles.cell_lists[i][y_clls - 1].first(), prtl);
+                AddHalo(store, prtl, SIDE_N);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, i, y_clls- 1);
             }
         }
     }
@@ -514,76 +458,52 @@ void Boundary::BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics
     //south-west corner
     //the rigid wall conditions         
     if(xBl == 0 && yBd == 0 || xBl == 2 && yBd == 2) {
-        //clear cell linked list data (particles)
-        particles.cell_lists[0][0].clear_data();
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p130 = particles.cell_lists[1][1].first(); 
-             !particles.cell_lists[1][1].isEnd(p130); 
-             p130 = particles.cell_lists[1][1].next(p130)) {
+        //iterate the correspeond cell
+        for(l = 0; l < cell_rings; l++) {
+            for(int p130 = particles.CellBegin(1 + l, 1); p130 < particles.CellEnd(1 + l, cell_rings); p130++) {
                                         
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[1][1].retrieve(p130);
-            Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
-
-            //boundary condition
-            Boundary_SW(prtl);
-
-            //in which cell
-            prtl->cell_i = 0; prtl->cell_j = 0; 
-            //insert its poistion on the image particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[0][0].insert(particles.cell_lists[0][0].first(), prtl);
+                //the original real particle
+                int prtl = store.AddImage(particles.particle_index[p130], hydro.materials[0]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_SW);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, 0, 0);
+            }
         }
     }
 
     //the symmetry conditions   
     if(xBl == 3 && yBd == 3) {
-        //clear cell linked list data (particles)
-        particles.cell_lists[0][0].clear_data();
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p130 = particles.cell_lists[1][1].first(); 
-             !particles.cell_lists[1][1].isEnd(p130); 
-             p130 = particles.cell_lists[1][1].next(p130)) {
+        //iterate the correspeond cell
+        for(l = 0; l < cell_rings; l++) {
+            for(int p130 = particles.CellBegin(1 + l, 1); p130 < particles.CellEnd(1 + l, cell_rings); p130++) {
                                         
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[1][1].retrieve(p130);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_SW(prtl);
-
-            //in which cell
-            prtl->cell_i = 0; prtl->cell_j = 0; 
-            //insert its poistion on the image particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[0][0].insert(particles.cell_lists[0][0].first(), prtl);
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p130]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_SW);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, 0, 0);
+            }
         }
     }
         
-    //the perodic conditions    
-    if(xBl == 1 && yBd == 1) {
-        //clear cell linked list data (particles)
-        particles.cell_lists[0][0].clear_data();
+    //the perodic conditions, not needed if a direction wraps around
+    if(xBl == 1 && yBd == 1 && !wrap_x && !wrap_y) {
         //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p131 = particles.cell_lists[x_clls - 2][y_clls - 2].first(); 
-             !particles.cell_lists[x_clls - 2][y_clls - 2].isEnd(p131); 
-             p131 = particles.cell_lists[x_clls - 2][y_clls - 2].next(p131)) {
+        for(l = 0; l < cell_rings; l++) {
+            for(int p131 = particles.CellBegin(x_clls - 2 - l, y_clls - 1 - cell_rings); p131 < particles.CellEnd(x_clls - 2 - l, y_clls - 2); p131++) {
                                         
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[x_clls - 2][y_clls - 2].retrieve(p131);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_SW(prtl);
-
-            //in which cell
-            prtl->cell_i = 0; prtl->cell_j = 0; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[0][0].insert(particles.cell_lists[0][0].first(), prtl);
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p131]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_SW);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, 0, 0);
+            }
         }
     }
                 
@@ -591,76 +511,52 @@ void Boundary::BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics
 
     //the rigid wall conditions         
     if(xBl == 0 && yBu == 0 || xBl == 2 && yBu == 2) {
-        //clear the linked list data (particles)
-        particles.cell_lists[0][y_clls - 1].clear_data();
         //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p140 = particles.cell_lists[1][y_clls - 2].first(); 
-             !particles.cell_lists[1][y_clls - 2].isEnd(p140); 
-             p140 = particles.cell_lists[1][y_clls - 2].next(p140)) {
+        for(l = 0; l < cell_rings; l++) {
+            for(int p140 = particles.CellBegin(1 + l, y_clls - 1 - cell_rings); p140 < particles.CellEnd(1 + l, y_clls - 2); p140++) {
                                 
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[1][y_clls - 2].retrieve(p140);
-            Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
-
-            //boundary condition
-            Boundary_NW(prtl);
-
-            //in which cell
-            prtl->cell_i = 0; prtl->cell_j = y_clls - 1; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[0][y_clls- 1].insert(particles.cell_lists[0][y_clls - 1].first(), prtl);
+                //the original real particle
+                int prtl = store.AddImage(particles.particle_index[p140], hydro.materials[0]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_NW);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, 0, y_clls- 1);
+            }
         }
     }
         
     //the symmetry conditions   
     if(xBl == 3 && yBu == 3) {
-        //clear the linked list data (particles)
-        particles.cell_lists[0][y_clls - 1].clear_data();
         //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p140 = particles.cell_lists[1][y_clls - 2].first(); 
-             !particles.cell_lists[1][y_clls - 2].isEnd(p140); 
-             p140 = particles.cell_lists[1][y_clls - 2].next(p140)) {
+        for(l = 0; l < cell_rings; l++) {
+            for(int p140 = particles.CellBegin(1 + l, y_clls - 1 - cell_rings); p140 < particles.CellEnd(1 + l, y_clls - 2); p140++) {
                                 
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[1][y_clls - 2].retrieve(p140);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_NW(prtl);
-
-            //in which cell
-            prtl->cell_i = 0; prtl->cell_j = y_clls - 1; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[0][y_clls- 1].insert(particles.cell_lists[0][y_clls - 1].first(), prtl);
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p140]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_NW);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, 0, y_clls- 1);
+            }
         }
     }
 
-    //the perodic conditions    
-    if(xBl == 1 && yBu == 1) {
-        //clear the linked list data (particles)
-        particles.cell_lists[0][y_clls - 1].clear_data();
+    //the perodic conditions, not needed if a direction wraps around
+    if(xBl == 1 && yBu == 1 && !wrap_x && !wrap_y) {
         //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p141 = particles.cell_lists[x_clls - 2][1].first(); 
-             !particles.cell_lists[x_clls - 2][1].isEnd(p141); 
-             p141 = particles.cell_lists[x_clls - 2][1].next(p141)) {
+        for(l = 0; l < cell_rings; l++) {
+            for(int p141 = particles.CellBegin(x_clls - 2 - l, 1); p141 < particles.CellEnd(x_clls - 2 - l, cell_rings); p141++) {
                                 
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[x_clls - 2][1].retrieve(p141);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_NW(prtl);
-
-            //in which cell
-            prtl->cell_i = 0; prtl->cell_j = y_clls - 1; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[0][y_clls- 1].insert(particles.cell_lists[0][y_clls - 1].first(), prtl);
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p141]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_NW);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, 0, y_clls- 1);
+            }
         }
     }
 
@@ -668,76 +564,52 @@ void Boundary::BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics
         
     //the rigid wall conditions         
     if(xBr == 0 && yBu == 0 || xBr == 2 && yBu == 2) {
-        //clear the linked list data (particles)
-        particles.cell_lists[x_clls - 1][y_clls - 1].clear_data();
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p240 = particles.cell_lists[x_clls - 2][y_clls - 2].first(); 
-             !particles.cell_lists[x_clls - 2][y_clls - 2].isEnd(p240); 
-             p240 = particles.cell_lists[x_clls - 2][y_clls - 2].next(p240)) {
+        //iterate the correspeond cell
+        for(l = 0; l < cell_rings; l++) {
+            for(int p240 = particles.CellBegin(x_clls - 2 - l, y_clls - 1 - cell_rings); p240 < particles.CellEnd(x_clls - 2 - l, y_clls - 2); p240++) {
                                 
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[x_clls - 2][y_clls - 2].retrieve(p240);
-            Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
-
-            //boundary condition
-            Boundary_NE(prtl);
-
-            //in which cell
-            prtl->cell_i = x_clls - 1; prtl->cell_j = y_clls - 1; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[x_clls- 1][y_clls - 1].insert(particles.cell_lists[x_clls - 1][y_clls - 1].first(), prtl);
+                //the original real particle
+                int prtl = store.AddImage(particles.particle_index[p240], hydro.materials[0]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_NE);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, x_clls- 1, y_clls - 1);
+            }
         }
     }
                 
     //the symmetry conditions   
     if(xBr == 3 && yBu == 3) {
-        //clear the linked list data (particles)
-        particles.cell_lists[x_clls - 1][y_clls - 1].clear_data();
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p240 = particles.cell_lists[x_clls - 2][y_clls - 2].first(); 
-             !particles.cell_lists[x_clls - 2][y_clls - 2].isEnd(p240); 
-             p240 = particles.cell_lists[x_clls - 2][y_clls - 2].next(p240)) {
+        //iterate the correspeond cell
+        for(l = 0; l < cell_rings; l++) {
+            for(int p240 = particles.CellBegin(x_clls - 2 - l, y_clls - 1 - cell_rings); p240 < particles.CellEnd(x_clls - 2 - l, y_clls - 2); p240++) {
                                 
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[x_clls - 2][y_clls - 2].retrieve(p240);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_NE(prtl);
-
-            //in which cell
-            prtl->cell_i = x_clls - 1; prtl->cell_j = y_clls - 1; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[x_clls- 1][y_clls - 1].insert(particles.cell_lists[x_clls - 1][y_clls - 1].first(), prtl);
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p240]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_NE);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, x_clls- 1, y_clls - 1);
+            }
         }
     }
 
-    //the perodic conditions    
-    if(xBr == 1 && yBu == 1) {
-        //clear the linked list data (particles)
-        particles.cell_lists[x_clls - 1][y_clls - 1].clear_data();
+    //the perodic conditions, not needed if a direction wraps around
+    if(xBr == 1 && yBu == 1 && !wrap_x && !wrap_y) {
         //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p241 = particles.cell_lists[1][1].first(); 
-             !particles.cell_lists[1][1].isEnd(p241); 
-             p241 = particles.cell_lists[1][1].next(p241)) {
+        for(l = 0; l < cell_rings; l++) {
+            for(int p241 = particles.CellBegin(1 + l, 1); p241 < particles.CellEnd(1 + l, cell_rings); p241++) {
                                         
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[1][1].retrieve(p241);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_NE(prtl);
-
-            //in which cell
-            prtl->cell_i = x_clls - 1; prtl->cell_j = y_clls - 1; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[x_clls- 1][y_clls - 1].insert(particles.cell_lists[x_clls - 1][y_clls - 1].first(), prtl);
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p241]);
+
+                //boundary condition
+                AddHalo(store, prtl, SIDE_NE);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, x_clls- 1, y_clls - 1);
+            }
         }
     }
 
@@ -745,623 +617,408 @@ void Boundary::BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics
         
     //the rigid wall conditions         
     if(xBr == 0 && yBd == 0 || xBr == 2 && yBd == 2) {
-        //clear the linked list data (particles)
-        particles.cell_lists[x_clls - 1][0].clear_data();
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p230 = particles.cell_lists[x_clls - 2][1].first(); 
-             !particles.cell_lists[x_clls - 2][1].isEnd(p230); 
-             p230 = particles.cell_lists[x_clls - 2][1].next(p230)) {
-                                
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[x_clls - 2][1].retrieve(p230);
-            Particle *prtl = new Particle(*prtl_old, hydro.materials[0]);
-
-            //boundary condition
-            Boundary_SE(prtl);
-
-            //in which cell
-            prtl->cell_i = x_clls - 1; prtl->cell_j = 0; 
-            //insert its poistion on the image particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[x_clls - 1][0].insert(particles.cell_lists[x_clls - 1][0].first(), prtl);
-        }
-    }
-
-    //the symmetry conditions   
-    if(xBr == 3 && yBd == 3) {
-        //clear the linked list data (particles)
-        particles.cell_lists[x_clls - 1][0].clear_data();
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p230 = particles.cell_lists[x_clls - 2][1].first(); 
-             !particles.cell_lists[x_clls - 2][1].isEnd(p230); 
-             p230 = particles.cell_lists[x_clls - 2][1].next(p230)) {
-                                
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[x_clls - 2][1].retrieve(p230);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_SE(prtl);
-
-            //in which cell
-            prtl->cell_i = x_clls - 1; prtl->cell_j = 0; 
-            //insert its poistion on the image particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[x_clls - 1][0].insert(particles.cell_lists[x_clls - 1][0].first(), prtl);
-        }
-    }
-
-    //the perodic conditions    
-    if(xBr == 1 && yBd == 1) {
-        //clear the linked list data (particles)
-        particles.cell_lists[x_clls - 1][0].clear_data();
-        //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p231 = particles.cell_lists[1][y_clls - 2].first(); 
-             !particles.cell_lists[1][y_clls - 2].isEnd(p231); 
-             p231 = particles.cell_lists[1][y_clls - 2].next(p231)) {
-                                        
-            //the original real particle
-            Particle *prtl_old = particles.cell_lists[1][y_clls - 2].retrieve(p231);
-            Particle *prtl = new Particle(*prtl_old);
-
-            //boundary condition
-            Boundary_SE(prtl);
-
-            //in which cell
-            prtl->cell_i = x_clls - 1; prtl->cell_j = 0; 
-            //insert its poistion on the particle list
-            boundary_particle_list.insert(boundary_particle_list.first(), prtl);
-            //insert the position into corresponding cell list
-            particles.cell_lists[x_clls - 1][0].insert(particles.cell_lists[x_clls - 1][0].first(), prtl);
-        }
-    }
-}
-//----------------------------------------------------------------------------------------
-//                                                      boundary condition
-//----------------------------------------------------------------------------------------
-void Boundary::BoundaryCondition(ParticleManager &particles)
-{
-    int i, j;
-
-    int kb, ku, mb, mu;
-    //default: no coner need to be considered
-    kb = 0; mb = x_clls;
-    ku = 0; mu = x_clls;
-        
-    //coners to be considered   
-    if(xBl == yBd) kb = 1; //south-west corner
-    if(xBr == yBd) mb = x_clls - 1; // south-east corner
-    if(xBl == yBu) ku = 1; //north-west corner
-    if(xBr == yBu) mu = x_clls - 1; //north-east corner
-
-    //x direction
-    for(j = 1; j < y_clls - 1; j++) {
-        
-        //west side
-        //the rigid wall conditions     
-        if(xBl == 0 || xBl == 2) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p1 = particles.cell_lists[0][j].first(); 
-                 !particles.cell_lists[0][j].isEnd(p1); 
-                 p1 = particles.cell_lists[0][j].next(p1)) {
-                                
-                Particle *prtl = particles.cell_lists[0][j].retrieve(p1);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 0);
-
-                //boundary condition
-                Boundary_W(prtl);
-            }
-        }
-        //the perodic or symmetry conditions    
-        if(xBl == 1 || xBl == 3) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p1 = particles.cell_lists[0][j].first(); 
-                 !particles.cell_lists[0][j].isEnd(p1); 
-                 p1 = particles.cell_lists[0][j].next(p1)) {
+        //iterate the correspeond cell
+        for(l = 0; l < cell_rings; l++) {
+            for(int p230 = particles.CellBegin(x_clls - 2 - l, 1); p230 < particles.CellEnd(x_clls - 2 - l, cell_rings); p230++) {
                                 
-                Particle *prtl = particles.cell_lists[0][j].retrieve(p1);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 1);
-
-                //boundary condition
-                Boundary_W(prtl);
-            }
-        }
-
-        //east side
-        //the rigid wall conditions     
-        if(xBr == 0 || xBr == 2) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p2 = particles.cell_lists[x_clls - 1][j].first(); 
-                 !particles.cell_lists[x_clls - 1][j].isEnd(p2); 
-                 p2 = particles.cell_lists[x_clls - 1][j].next(p2)) {
-                                        
-                Particle *prtl = particles.cell_lists[x_clls - 1][j].retrieve(p2);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 0);
-
-                //boundary condition
-                Boundary_E(prtl);
-            }
-        }
-        //the perodic or symmetry conditions    
-        if(xBr == 1 || xBr == 3) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p2 = particles.cell_lists[x_clls - 1][j].first(); 
-                 !particles.cell_lists[x_clls - 1][j].isEnd(p2); 
-                 p2 = particles.cell_lists[x_clls - 1][j].next(p2)) {
-                                        
-                Particle *prtl = particles.cell_lists[x_clls - 1][j].retrieve(p2);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 1);
+                //the original real particle
+                int prtl = store.AddImage(particles.particle_index[p230], hydro.materials[0]);
 
                 //boundary condition
-                Boundary_E(prtl);
+                AddHalo(store, prtl, SIDE_SE);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, x_clls - 1, 0);
             }
         }
     }
 
-    //y direction
-        
-    //south side
-    for(i = kb; i < mb; i++) {
-        //the rigid wall conditions     
-        if(yBd == 0 || yBd == 2) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p3 = particles.cell_lists[i][0].first(); 
-                 !particles.cell_lists[i][0].isEnd(p3); 
-                 p3 = particles.cell_lists[i][0].next(p3)) {
-                                        
-                Particle *prtl = particles.cell_lists[i][0].retrieve(p3);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 0);
-
-                //boundary condition
-                Boundary_S(prtl);
-            }
-        }
-        //the perodic or symmetry conditions    
-        if(yBd == 1 || yBd == 3) {
-            //iterate the correspeond cell linked list
-            for (LlistNode<Particle> *p3 = particles.cell_lists[i][0].first(); 
-                 !particles.cell_lists[i][0].isEnd(p3); 
-                 p3 = particles.cell_lists[i][0].next(p3)) {
-                                        
-                Particle *prtl = particles.cell_lists[i][0].retrieve(p3);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 1);
+    //the symmetry conditions   
+    if(xBr == 3 && yBd == 3) {
+        //iterate the correspeond cell
+        for(l = 0; l < cell_rings; l++) {
+            for(int p230 = particles.CellBegin(x_clls - 2 - l, 1); p230 < particles.CellEnd(x_clls - 2 - l, cell_rings); p230++) {
+                                
+                //the original real particle
+                int prtl = store.AddGhost(particles.particle_index[p230]);
 
                 //boundary condition
-                Boundary_S(prtl);
+                AddHalo(store, prtl, SIDE_SE);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, x_clls - 1, 0);
             }
         }
     }
 
-    //north side
-    for(i = ku; i < mu; i++) {
-        //the rigid wall conditions     
-        if(yBu == 0 || yBu == 2) {
-            //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p4 = particles.cell_lists[i][y_clls - 1].first(); 
-                 !particles.cell_lists[i][y_clls - 1].isEnd(p4); 
-                 p4 = particles.cell_lists[i][y_clls - 1].next(p4)) {
-                                        
-                //the original real particle
-                Particle *prtl = particles.cell_lists[i][y_clls - 1].retrieve(p4);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 0);
-        
-                //boundary condition
-                Boundary_N(prtl);
-            }
-        }
-        //the perodic or symmetry conditions    
-        if(yBu == 1 || yBu == 3) {
-            //iterate the correspeond cell for real and wall partilces
-            for (LlistNode<Particle> *p4 = particles.cell_lists[i][y_clls - 1].first(); 
-                 !particles.cell_lists[i][y_clls - 1].isEnd(p4); 
-                 p4 = particles.cell_lists[i][y_clls - 1].next(p4)) {
+    //the perodic conditions, not needed if a direction wraps around
+    if(xBr == 1 && yBd == 1 && !wrap_x && !wrap_y) {
+        //iterate the correspeond cell for real and wall partilces
+        for(l = 0; l < cell_rings; l++) {
+            for(int p231 = particles.CellBegin(1 + l, y_clls - 1 - cell_rings); p231 < particles.CellEnd(1 + l, y_clls - 2); p231++) {
                                         
                 //the original real particle
-                Particle *prtl = particles.cell_lists[i][y_clls - 1].retrieve(p4);
-                //copy states from the original particle
-                prtl->StatesCopier(*prtl->rl_prtl, 1);
-        
+                int prtl = store.AddGhost(particles.particle_index[p231]);
+
                 //boundary condition
-                Boundary_N(prtl);
+                AddHalo(store, prtl, SIDE_SE);
+                //put it into the corresponding cell
+                particles.AssignCell(prtl, x_clls - 1, 0);
             }
         }
     }
 
-    //considering the coner cells
-
-    //south-west corner
-    //the rigid wall conditions         
-    if(xBl == 0 && yBd == 0 || xBl == 2 && yBd == 2) {
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p13 = particles.cell_lists[0][0].first(); 
-             !particles.cell_lists[0][0].isEnd(p13); 
-             p13 = particles.cell_lists[0][0].next(p13)) {
-                                        
-            Particle *prtl = particles.cell_lists[0][0].retrieve(p13);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 0);
-
-            //boundary condition
-            Boundary_SW(prtl);
-        }
-    }
-    //the perodic or symmetry conditions        
-    if(xBl == 1 && yBd == 1 || xBl == 3 && yBd == 3) {
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p13 = particles.cell_lists[0][0].first(); 
-             !particles.cell_lists[0][0].isEnd(p13); 
-             p13 = particles.cell_lists[0][0].next(p13)) {
-                                        
-            Particle *prtl = particles.cell_lists[0][0].retrieve(p13);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 1);
-
-            //boundary condition
-            Boundary_SW(prtl);
-        }
-    }
-                
-    //north-west corner
-    //the rigid wall conditions         
-    if(xBl == 0 && yBu == 0 || xBl == 2 && yBu == 2) {
-        //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p14 = particles.cell_lists[0][y_clls - 1].first(); 
-             !particles.cell_lists[0][y_clls - 1].isEnd(p14); 
-             p14 = particles.cell_lists[0][y_clls - 1].next(p14)) {
-                                        
-            //the original real particle
-            Particle *prtl = particles.cell_lists[0][y_clls - 1].retrieve(p14);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 0);
-
-            //boundary condition
-            Boundary_NW(prtl);
-        }
-    }
-    //the perodic or symmetry conditions        
-    if(xBl == 1 && yBu == 1 || xBl == 3 && yBu == 3) {
-        //iterate the correspeond cell for real and wall partilces
-        for (LlistNode<Particle> *p14 = particles.cell_lists[0][y_clls - 1].first(); 
-             !particles.cell_lists[0][y_clls - 1].isEnd(p14); 
-             p14 = particles.cell_lists[0][y_clls - 1].next(p14)) {
-                                        
-            //the original real particle
-            Particle *prtl = particles.cell_lists[0][y_clls - 1].retrieve(p14);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 1);
-
-            //boundary condition
-            Boundary_NW(prtl);
-        }
-    }
-
-    //north-east corner
-    //the rigid wall conditions         
-    if(xBr == 0 && yBu == 0 || xBr == 2 && yBu == 2) {
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p24 = particles.cell_lists[x_clls - 1][y_clls - 1].first(); 
-             !particles.cell_lists[x_clls - 1][y_clls - 1].isEnd(p24); 
-             p24 = particles.cell_lists[x_clls - 1][y_clls - 1].next(p24)) {
-                                
-            //the original real particle
-            Particle *prtl = particles.cell_lists[x_clls - 1][y_clls - 1].retrieve(p24);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 0);
+    //sort all particles into the cells
+    particles.SortParticles();
+}
+//----------------------------------------------------------------------------------------
+//                                                      boundary condition
+//----------------------------------------------------------------------------------------
+void Boundary::BoundaryCondition(ParticleManager &particles, int fields)
+{
+    ParticleStore &store = particles.store;
 
-            //boundary condition
-            Boundary_NE(prtl);
-        }
+    //the boundary particles copied from real particles first,
+    //then the ones which may be copied from the first ones
+    SyncHalo(store, store.number_of_real, halo_split, fields);
+    SyncHalo(store, halo_split, store.number_of_particles, fields);
+}
+//----------------------------------------------------------------------------------------
+//              copy states to a range of boundary particles and impose their sides
+//----------------------------------------------------------------------------------------
+void Boundary::SyncHalo(ParticleStore &store, int first, int last, int fields)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int prtl = first; prtl < last; prtl++) {
+        const int side = halo_side[prtl - store.number_of_real];
+        //copy states from the original particle
+        store.StatesCopier(prtl, CopierType(side), fields);
+        //boundary condition
+        ImposeSide(store, prtl, side, fields);
     }
-    //the perodic or symmetry conditions        
-    if(xBr == 1 && yBu == 1 || xBr == 3 && yBu == 3) {
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p24 = particles.cell_lists[x_clls - 1][y_clls - 1].first(); 
-             !particles.cell_lists[x_clls - 1][y_clls - 1].isEnd(p24); 
-             p24 = particles.cell_lists[x_clls - 1][y_clls - 1].next(p24)) {
-                                
-            //the original real particle
-            Particle *prtl = particles.cell_lists[x_clls - 1][y_clls - 1].retrieve(p24);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 1);
-
-            //boundary condition
-            Boundary_NE(prtl);
-        }
+}
+//----------------------------------------------------------------------------------------
+//                      record the side of a new boundary particle and impose it
+//----------------------------------------------------------------------------------------
+void Boundary::AddHalo(ParticleStore &store, int prtl, int side)
+{
+    const int k = prtl - store.number_of_real;
+    if(k >= halo_side_length) {
+        int *sides = new int[2*halo_side_length];
+        for(int n = 0; n < halo_side_length; n++) sides[n] = halo_side[n];
+        delete[] halo_side;
+        halo_side = sides;
+        halo_side_length *= 2;
     }
+    halo_side[k] = side;
 
-    //south-east corner
-    //the rigid wall conditions         
-    if(xBr == 0 && yBd == 0 || xBr == 2 && yBd == 2) {  
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p23 = particles.cell_lists[x_clls - 1][0].first(); 
-             !particles.cell_lists[x_clls - 1][0].isEnd(p23); 
-             p23 = particles.cell_lists[x_clls - 1][0].next(p23)) {
-                                        
-            //the original real particle
-            Particle *prtl = particles.cell_lists[x_clls - 1][0].retrieve(p23);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 0);
-        
-            //boundary condition
-            Boundary_SE(prtl);
-        }
+    //all states of the new boundary particle
+    store.StatesCopier(prtl, CopierType(side));
+    ImposeSide(store, prtl, side, ParticleStore::ALL_STATES);
+}
+//----------------------------------------------------------------------------------------
+//              states copier type of a side, 0: wall image, 1: periodic or symmetry ghost
+//----------------------------------------------------------------------------------------
+int Boundary::CopierType(int side) const
+{
+    int type;
+    switch(side) {
+    case SIDE_W: case SIDE_SW: case SIDE_NW: type = xBl; break;
+    case SIDE_E: case SIDE_SE: case SIDE_NE: type = xBr; break;
+    case SIDE_S: type = yBd; break;
+    default: type = yBu; break;
     }
-
-    //the perodic or symmetry conditions        
-    if(xBr == 1 && yBd == 1 || xBr == 3 && yBd == 3) {  
-        //iterate the correspeond cell linked list
-        for (LlistNode<Particle> *p23 = particles.cell_lists[x_clls - 1][0].first(); 
-             !particles.cell_lists[x_clls - 1][0].isEnd(p23); 
-             p23 = particles.cell_lists[x_clls - 1][0].next(p23)) {
-                                        
-            //the original real particle
-            Particle *prtl = particles.cell_lists[x_clls - 1][0].retrieve(p23);
-            //copy states from the original particle
-            prtl->StatesCopier(*prtl->rl_prtl, 1);
-
-            //boundary condition
-            Boundary_SE(prtl);
-        }
+    return type == 1 || type == 3 ? 1 : 0;
+}
+//----------------------------------------------------------------------------------------
+//                              impose the boundary condition of a side
+//----------------------------------------------------------------------------------------
+void Boundary::ImposeSide(ParticleStore &store, int prtl, int side, int fields)
+{
+    switch(side) {
+    case SIDE_W: Boundary_W(store, prtl, fields); break;
+    case SIDE_E: Boundary_E(store, prtl, fields); break;
+    case SIDE_S: Boundary_S(store, prtl, fields); break;
+    case SIDE_N: Boundary_N(store, prtl, fields); break;
+    case SIDE_SW: Boundary_SW(store, prtl, fields); break;
+    case SIDE_SE: Boundary_SE(store, prtl, fields); break;
+    case SIDE_NW: Boundary_NW(store, prtl, fields); break;
+    case SIDE_NE: Boundary_NE(store, prtl, fields); break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement west side boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_W(Particle *prtl)
+void Boundary::Boundary_W(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(xBl) {
         //wall
     case 0: 
-        prtl->R[0] = - prtl->R[0]; 
-        prtl->U = UxBl*2.0 - prtl->U;
+        if(position) store.R[prtl][0] = - store.R[prtl][0]; 
+        if(velocity) store.U[prtl] = UxBl*2.0 - store.U[prtl];
         break;
         //perodic
     case 1:
-        prtl->R[0] = prtl->R[0] - box_size[0];
+        if(position) store.R[prtl][0] = store.R[prtl][0] - box_size[0];
         break;
         //free slip wall
     case 2: 
-        prtl->R[0] = - prtl->R[0]; 
-        prtl->U[0] = UxBl[0]*2.0 - prtl->U[0];
+        if(position) store.R[prtl][0] = - store.R[prtl][0]; 
+        if(velocity) store.U[prtl][0] = UxBl[0]*2.0 - store.U[prtl][0];
         break;
         //symmetry
     case 3: 
-        prtl->R[0] = - prtl->R[0]; 
-        prtl->U[0] = UxBl[0]*2.0 - prtl->U[0];
-        prtl->del_phi[0] = - prtl->del_phi[0];
+        if(position) store.R[prtl][0] = - store.R[prtl][0]; 
+        if(velocity) store.U[prtl][0] = UxBl[0]*2.0 - store.U[prtl][0];
+        if(gradient) store.del_phi[prtl][0] = - store.del_phi[prtl][0];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement east side boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_E(Particle *prtl)
+void Boundary::Boundary_E(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(xBr) {
         //wall
     case 0: 
-        prtl->R[0] = box_size[0]*2.0 - prtl->R[0]; 
-        prtl->U = UxBr*2.0 - prtl->U;
+        if(position) store.R[prtl][0] = box_size[0]*2.0 - store.R[prtl][0]; 
+        if(velocity) store.U[prtl] = UxBr*2.0 - store.U[prtl];
         break;
         //perodic
     case 1:
-        prtl->R[0] = prtl->R[0] + box_size[0];
+        if(position) store.R[prtl][0] = store.R[prtl][0] + box_size[0];
         break;
         //free slip wall
     case 2: 
-        prtl->R[0] = box_size[0]*2.0 - prtl->R[0]; 
-        prtl->U[0] = UxBr[0]*2.0 - prtl->U[0];
+        if(position) store.R[prtl][0] = box_size[0]*2.0 - store.R[prtl][0]; 
+        if(velocity) store.U[prtl][0] = UxBr[0]*2.0 - store.U[prtl][0];
         break;
         //symmetry
     case 3: 
-        prtl->R[0] = box_size[0]*2.0 - prtl->R[0]; 
-        prtl->U[0] = UxBr[0]*2.0 - prtl->U[0];
-        prtl->del_phi[0] = - prtl->del_phi[0];
+        if(position) store.R[prtl][0] = box_size[0]*2.0 - store.R[prtl][0]; 
+        if(velocity) store.U[prtl][0] = UxBr[0]*2.0 - store.U[prtl][0];
+        if(gradient) store.del_phi[prtl][0] = - store.del_phi[prtl][0];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement south side boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_S(Particle *prtl)
+void Boundary::Boundary_S(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(yBd) {
         //wall
     case 0: 
-        prtl->R[1] = - prtl->R[1]; 
-        prtl->U = UyBd*2.0 - prtl->U;
+        if(position) store.R[prtl][1] = - store.R[prtl][1]; 
+        if(velocity) store.U[prtl] = UyBd*2.0 - store.U[prtl];
         break;
         //perodic
     case 1:
-        prtl->R[1] = prtl->R[1] - box_size[1];
+        if(position) store.R[prtl][1] = store.R[prtl][1] - box_size[1];
         break;
         //free slip wall
     case 2: 
-        prtl->R[1] = - prtl->R[1]; 
-        prtl->U[1] = UyBd[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl][1] = - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][1] = UyBd[1]*2.0 - store.U[prtl][1];
         break;
         //symmetry
     case 3: 
-        prtl->R[1] = - prtl->R[1]; 
-        prtl->U[1] = UyBd[1]*2.0 - prtl->U[1];
-        prtl->del_phi[1] = - prtl->del_phi[1];
+        if(position) store.R[prtl][1] = - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][1] = UyBd[1]*2.0 - store.U[prtl][1];
+        if(gradient) store.del_phi[prtl][1] = - store.del_phi[prtl][1];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement north side boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_N(Particle *prtl)
+void Boundary::Boundary_N(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(yBu) {
         //wall
     case 0: 
-        prtl->R[1] = box_size[1]*2.0 - prtl->R[1]; 
-        prtl->U = UyBu*2.0 - prtl->U;
+        if(position) store.R[prtl][1] = box_size[1]*2.0 - store.R[prtl][1]; 
+        if(velocity) store.U[prtl] = UyBu*2.0 - store.U[prtl];
         break;
         //perodic
     case 1:
-        prtl->R[1] = prtl->R[1] + box_size[1];
+        if(position) store.R[prtl][1] = store.R[prtl][1] + box_size[1];
         break;
         //free slip wall
     case 2: 
-        prtl->R[1] = box_size[1]*2.0 - prtl->R[1]; 
-        prtl->U[1] = UyBu[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl][1] = box_size[1]*2.0 - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][1] = UyBu[1]*2.0 - store.U[prtl][1];
         break;
         //symmetry
     case 3: 
-        prtl->R[1] = box_size[1]*2.0 - prtl->R[1]; 
-        prtl->U[1] = UyBu[1]*2.0 - prtl->U[1];
-        prtl->del_phi[1] = - prtl->del_phi[1];
+        if(position) store.R[prtl][1] = box_size[1]*2.0 - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][1] = UyBu[1]*2.0 - store.U[prtl][1];
+        if(gradient) store.del_phi[prtl][1] = - store.del_phi[prtl][1];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement south-west corner boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_SW(Particle *prtl)
+void Boundary::Boundary_SW(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(xBl) {
         //wall
     case 0: 
-        prtl->R = - prtl->R;
-        prtl->U[0] = UyBd[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBl[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl] = - store.R[prtl];
+        if(velocity) store.U[prtl][0] = UyBd[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBl[1]*2.0 - store.U[prtl][1];
         break;
         //perodic
     case 1:
-        prtl->R = prtl->R - box_size;
+        if(position) store.R[prtl] = store.R[prtl] - box_size;
         break;
         //free slip wall
     case 2: 
-        prtl->R = - prtl->R;
-        prtl->U[0] = UyBd[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBl[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl] = - store.R[prtl];
+        if(velocity) store.U[prtl][0] = UyBd[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBl[1]*2.0 - store.U[prtl][1];
         break;
         //symmetry
     case 3: 
-        prtl->R = - prtl->R;
-        prtl->U[0] = UyBd[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBl[1]*2.0 - prtl->U[1];
-        prtl->del_phi = - prtl->del_phi;
+        if(position) store.R[prtl] = - store.R[prtl];
+        if(velocity) store.U[prtl][0] = UyBd[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBl[1]*2.0 - store.U[prtl][1];
+        if(gradient) store.del_phi[prtl] = - store.del_phi[prtl];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement north-west corner boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_NW(Particle *prtl)
+void Boundary::Boundary_NW(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(xBl) {
         //wall
     case 0: 
-        prtl->R[0] = - prtl->R[0]; 
-        prtl->R[1] = box_size[1]*2.0 - prtl->R[1]; 
-        prtl->U[0] = UyBu[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBl[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl][0] = - store.R[prtl][0]; 
+        if(position) store.R[prtl][1] = box_size[1]*2.0 - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][0] = UyBu[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBl[1]*2.0 - store.U[prtl][1];
         break;
         //perodic
     case 1:
-        prtl->R[0] = prtl->R[0] - box_size[0];
-        prtl->R[1] = prtl->R[1] + box_size[1];
+        if(position) store.R[prtl][0] = store.R[prtl][0] - box_size[0];
+        if(position) store.R[prtl][1] = store.R[prtl][1] + box_size[1];
         break;
         //free slip wall
     case 2: 
-        prtl->R[0] = - prtl->R[0]; 
-        prtl->R[1] = box_size[1]*2.0 - prtl->R[1]; 
-        prtl->U[0] = UyBu[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBl[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl][0] = - store.R[prtl][0]; 
+        if(position) store.R[prtl][1] = box_size[1]*2.0 - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][0] = UyBu[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBl[1]*2.0 - store.U[prtl][1];
         break;
         //symmetry
     case 3: 
-        prtl->R[0] = - prtl->R[0]; 
-        prtl->R[1] = box_size[1]*2.0 - prtl->R[1]; 
-        prtl->U[0] = UyBu[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBl[1]*2.0 - prtl->U[1];
-        prtl->del_phi = - prtl->del_phi;
+        if(position) store.R[prtl][0] = - store.R[prtl][0]; 
+        if(position) store.R[prtl][1] = box_size[1]*2.0 - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][0] = UyBu[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBl[1]*2.0 - store.U[prtl][1];
+        if(gradient) store.del_phi[prtl] = - store.del_phi[prtl];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement north-east corner boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_NE(Particle *prtl)
+void Boundary::Boundary_NE(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(xBr) {
         //wall
     case 0: 
-        prtl->R = box_size*2.0 - prtl->R; 
-        prtl->U[0] = UyBu[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBr[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl] = box_size*2.0 - store.R[prtl]; 
+        if(velocity) store.U[prtl][0] = UyBu[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBr[1]*2.0 - store.U[prtl][1];
         break;
         //perodic
     case 1:
-        prtl->R = prtl->R + box_size;
+        if(position) store.R[prtl] = store.R[prtl] + box_size;
         break;
         //free slip wall
     case 2: 
-        prtl->R = box_size*2.0 - prtl->R; 
-        prtl->U[0] = UyBu[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBr[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl] = box_size*2.0 - store.R[prtl]; 
+        if(velocity) store.U[prtl][0] = UyBu[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBr[1]*2.0 - store.U[prtl][1];
         break;
         //symmetry
     case 3: 
-        prtl->R = box_size*2.0 - prtl->R; 
-        prtl->U[0] = UyBu[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBr[1]*2.0 - prtl->U[1];
-        prtl->del_phi = - prtl->del_phi;
+        if(position) store.R[prtl] = box_size*2.0 - store.R[prtl]; 
+        if(velocity) store.U[prtl][0] = UyBu[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBr[1]*2.0 - store.U[prtl][1];
+        if(gradient) store.del_phi[prtl] = - store.del_phi[prtl];
         break;
     }
 }
 //----------------------------------------------------------------------------------------
 //                      implement north-east corner boubadry by modeify particle states
 //----------------------------------------------------------------------------------------
-void Boundary::Boundary_SE(Particle *prtl)
+void Boundary::Boundary_SE(ParticleStore &store, int prtl, int fields)
 {
+    const bool position = fields & ParticleStore::POSITION, velocity = fields & ParticleStore::VELOCITY;
+    const bool gradient = fields & ParticleStore::PHASE_GRADIENT;
+
     //the rigid wall conditions 
     switch(xBr) {
         //wall
     case 0: 
-        prtl->R[0] = box_size[0]*2.0 - prtl->R[0]; 
-        prtl->R[1] = - prtl->R[1]; 
-        prtl->U[0] = UyBd[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBr[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl][0] = box_size[0]*2.0 - store.R[prtl][0]; 
+        if(position) store.R[prtl][1] = - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][0] = UyBd[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBr[1]*2.0 - store.U[prtl][1];
         break;
         //perodic
     case 1:
-        prtl->R[0] = prtl->R[0] + box_size[0];
-        prtl->R[1] = prtl->R[1] - box_size[1];
+        if(position) store.R[prtl][0] = store.R[prtl][0] + box_size[0];
+        if(position) store.R[prtl][1] = store.R[prtl][1] - box_size[1];
         break;
         //free slip wall
     case 2: 
-        prtl->R[0] = box_size[0]*2.0 - prtl->R[0]; 
-        prtl->R[1] = - prtl->R[1]; 
-        prtl->U[0] = UyBd[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBr[1]*2.0 - prtl->U[1];
+        if(position) store.R[prtl][0] = box_size[0]*2.0 - store.R[prtl][0]; 
+        if(position) store.R[prtl][1] = - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][0] = UyBd[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBr[1]*2.0 - store.U[prtl][1];
         break;
         //symmetry
     case 3: 
-        prtl->R[0] = box_size[0]*2.0 - prtl->R[0]; 
-        prtl->R[1] = - prtl->R[1]; 
-        prtl->U[0] = UyBd[0]*2.0 - prtl->U[0];
-        prtl->U[1] = UxBr[1]*2.0 - prtl->U[1];
-        prtl->del_phi = - prtl->del_phi;
+        if(position) store.R[prtl][0] = box_size[0]*2.0 - store.R[prtl][0]; 
+        if(position) store.R[prtl][1] = - store.R[prtl][1]; 
+        if(velocity) store.U[prtl][0] = UyBd[0]*2.0 - store.U[prtl][0];
+        if(velocity) store.U[prtl][1] = UxBr[1]*2.0 - store.U[prtl][1];
+        if(gradient) store.del_phi[prtl] = - store.del_phi[prtl];
         break;
     }
 }               
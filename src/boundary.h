@@ -3,7 +3,6 @@
 
 
 class Initiation;
-class Particle;
 class ParticleManager;
 class Hydrodynamics;
 
@@ -17,21 +16,39 @@ class Boundary
     ///cell matrix size
     int x_clls, y_clls;
     int number_of_materials;
+    ///periodic directions wrapped by the nearest image instead of ghost particles
+    bool wrap_x, wrap_y;
+
+    ///side of each boundary particle, the boundary particles are 
+    ///store.number_of_real ... store.number_of_particles - 1
+    enum Side { SIDE_W, SIDE_E, SIDE_S, SIDE_N, SIDE_SW, SIDE_SE, SIDE_NW, SIDE_NE };
+    int *halo_side;
+    int halo_side_length; ///length of the halo_side array
+    ///the boundary particles from halo_split on may be copied from other boundary particles
+    int halo_split;
 
     ///non-dimensionalize
     void non_dimensionalize(Initiation &ini);
     ///show information on screen
     void show_information(Initiation &ini);
 
-    ///implement a side boubadry by modeify particle states
-    void Boundary_W(Particle *prtl);
-    void Boundary_E(Particle *prtl);
-    void Boundary_S(Particle *prtl);
-    void Boundary_N(Particle *prtl);
-    void Boundary_SW(Particle *prtl);
-    void Boundary_SE(Particle *prtl);
-    void Boundary_NW(Particle *prtl);
-    void Boundary_NE(Particle *prtl);
+    ///implement a side boubadry by modeify particle states, only the states given by fields
+    void Boundary_W(ParticleStore &store, int prtl, int fields);
+    void Boundary_E(ParticleStore &store, int prtl, int fields);
+    void Boundary_S(ParticleStore &store, int prtl, int fields);
+    void Boundary_N(ParticleStore &store, int prtl, int fields);
+    void Boundary_SW(ParticleStore &store, int prtl, int fields);
+    void Boundary_SE(ParticleStore &store, int prtl, int fields);
+    void Boundary_NW(ParticleStore &store, int prtl, int fields);
+    void Boundary_NE(ParticleStore &store, int prtl, int fields);
+    ///impose the boundary condition of a side
+    void ImposeSide(ParticleStore &store, int prtl, int side, int fields);
+    ///states copier type of a side, 0: wall image, 1: periodic or symmetry ghost
+    int CopierType(int side) const;
+    ///record the side of a new boundary particle and set all its states
+    void AddHalo(ParticleStore &store, int prtl, int side);
+    ///copy the states given by fields to the boundary particles first ... last - 1
+    void SyncHalo(ParticleStore &store, int first, int last, int fields);
 
 public:
     ///boundary condition indicator
@@ -43,16 +60,16 @@ public:
     int  xBl, xBr, yBd, yBu;
     Vec2d UxBl, UxBr, UyBd, UyBu; ///boundary velocity
 
-    ///boundary particle lists
-    Llist<Particle> boundary_particle_list; ///boundary particle list for all boundray particles
-
     ///constructor
     Boundary(Initiation &ini, Hydrodynamics &hydro, ParticleManager &particles);
+    ///destructor
+    ~Boundary();
 
     ///build boundary particles
     void BuildBoundaryParticles(ParticleManager &particles, Hydrodynamics &hydro);
-    ///boundary conditions
-    void BoundaryCondition(ParticleManager &particles);
+    ///boundary conditions, only the states given by fields (ParticleStore::States) 
+    ///are copied from the original particles
+    void BoundaryCondition(ParticleManager &particles, int fields = ParticleStore::ALL_STATES);
     ///check particle if particle run out of the computational domain
     void RunAwayCheck(Hydrodynamics &hydro);
 };
@@ -0,0 +1,99 @@
+// correlator.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Multiple-tau correlator for time correlation functions
+//              correlator.cpp
+//----------------------------------------------------------------------------------------
+
+// ***** localincludes *****
+#include "correlator.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+Correlator::Correlator(int dimension):
+dimension(dimension), number_of_levels(0)
+{
+    NewLevel(0);
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+Correlator::~Correlator()
+{
+    for(int l = 0; l < number_of_levels; l++) {
+        delete[] shift[l]; delete[] accumulator[l];
+        delete[] correlation[l]; delete[] count[l];
+    }
+}
+//----------------------------------------------------------------------------------------
+//                                      allocate a level
+//----------------------------------------------------------------------------------------
+void Correlator::NewLevel(int l)
+{
+    int i;
+
+    shift[l] = new double[CORRELATOR_POINTS*dimension];
+    accumulator[l] = new double[dimension];
+    correlation[l] = new double[CORRELATOR_POINTS];
+    count[l] = new long long[CORRELATOR_POINTS];
+    for(i = 0; i < dimension; i++) accumulator[l][i] = 0.0;
+    for(i = 0; i < CORRELATOR_POINTS; i++) {
+        correlation[l][i] = 0.0; count[l][i] = 0;
+    }
+    insert[l] = 0; number_of_values[l] = 0; accumulated[l] = 0;
+    number_of_levels = l + 1;
+}
+//----------------------------------------------------------------------------------------
+//                                      add a value to a level
+//----------------------------------------------------------------------------------------
+void Correlator::Add(int l, const double *a)
+{
+    int i, j;
+    double *value = shift[l] + insert[l]*dimension;
+
+    for(i = 0; i < dimension; i++) value[i] = a[i];
+    number_of_values[l]++;
+
+    //the products with the values before, the lags below CORRELATOR_POINTS/CORRELATOR_AVERAGING
+    //are already on the level before
+    const int first = l == 0 ? 0 : CORRELATOR_POINTS/CORRELATOR_AVERAGING;
+    const int last = number_of_values[l] < CORRELATOR_POINTS ? int(number_of_values[l]) : CORRELATOR_POINTS;
+    for(j = first; j < last; j++) {
+        const double *before = shift[l] + ((insert[l] - j + CORRELATOR_POINTS)%CORRELATOR_POINTS)*dimension;
+        double product = 0.0;
+        for(i = 0; i < dimension; i++) product += value[i]*before[i];
+        correlation[l][j] += product;
+        count[l][j]++;
+    }
+    insert[l] = (insert[l] + 1)%CORRELATOR_POINTS;
+
+    //the average for the next level
+    for(i = 0; i < dimension; i++) accumulator[l][i] += a[i];
+    if(++accumulated[l] == CORRELATOR_AVERAGING) {
+        for(i = 0; i < dimension; i++) accumulator[l][i] /= double(CORRELATOR_AVERAGING);
+        if(l + 1 < CORRELATOR_LEVELS) {
+            if(l + 1 == number_of_levels) NewLevel(l + 1);
+            Add(l + 1, accumulator[l]);
+        }
+        for(i = 0; i < dimension; i++) accumulator[l][i] = 0.0;
+        accumulated[l] = 0;
+    }
+}
+//----------------------------------------------------------------------------------------
+//                      the correlation at point j of level l
+//----------------------------------------------------------------------------------------
+bool Correlator::Result(int l, int j, double &lag, double &value) const
+{
+    if(l >= number_of_levels || (l > 0 && j < CORRELATOR_POINTS/CORRELATOR_AVERAGING) 
+       || count[l][j] == 0) return false;
+
+    lag = j;
+    for(int i = 0; i < l; i++) lag *= CORRELATOR_AVERAGING;
+    value = correlation[l][j]/double(count[l][j]);
+    return true;
+}
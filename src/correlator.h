@@ -0,0 +1,57 @@
+/// \file correlator.h
+/// \brief Multiple-tau correlator for time correlation functions
+
+#ifndef CORRELATOR_H
+#define CORRELATOR_H
+
+enum { CORRELATOR_POINTS = 16, CORRELATOR_AVERAGING = 2, CORRELATOR_LEVELS = 48 };
+
+/// Multiple-tau correlator for time correlation functions
+///
+/// The autocorrelation <a(t).a(t + lag)> of a vector a of the given dimension,
+/// summed over its components, with the lags spaced logarithmically
+/// (Ramirez, Sukumaran, Vorselaars and Likhtman, J. Chem. Phys. 133, 154103 (2010)).
+/// Level 0 correlates the samples with the CORRELATOR_POINTS samples before,
+/// level l the averages of CORRELATOR_AVERAGING^l samples, at the lags
+/// j*CORRELATOR_AVERAGING^l for j = CORRELATOR_POINTS/CORRELATOR_AVERAGING ... 
+/// CORRELATOR_POINTS - 1. A level is allocated when the first average reaches it,
+/// so the memory grows with the logarithm of the number of samples.
+class Correlator {
+
+    int dimension;
+    ///number of allocated levels
+    int number_of_levels;
+    ///per level: the last CORRELATOR_POINTS values, position of the next value
+    ///and number of values so far
+    double *shift[CORRELATOR_LEVELS];
+    int insert[CORRELATOR_LEVELS];
+    long long number_of_values[CORRELATOR_LEVELS];
+    ///per level: sum of the values to be averaged for the next level and their number
+    double *accumulator[CORRELATOR_LEVELS];
+    int accumulated[CORRELATOR_LEVELS];
+    ///per level and lag: sum of the products and their number
+    double *correlation[CORRELATOR_LEVELS];
+    long long *count[CORRELATOR_LEVELS];
+
+    ///allocate level l
+    void NewLevel(int l);
+    ///add a value to level l
+    void Add(int l, const double *a);
+
+public:
+
+    ///constructor
+    Correlator(int dimension);
+    ///destructor
+    ~Correlator();
+
+    ///add a sample of the vector
+    void Add(const double *a) { Add(0, a); }
+    ///number of allocated levels
+    int Levels() const { return number_of_levels; }
+    ///the correlation at point j of level l and its lag in samples,
+    ///false if the point is not used or has no products yet
+    bool Result(int l, int j, double &lag, double &value) const;
+};
+
+#endif
@@ -13,16 +13,21 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 
 // ***** localincludes *****
 #include "glbcls.h"
 #include "glbfunc.h"
 #include "diagnose.h"
 #include "initiation.h"
-#include "particle.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
 #include "mls.h"
 #include "particlemanager.h"
+#include "gridmapping.h"
+#include "quinticspline.h"
+#include "correlator.h"
 #include "material.h"
 
 using namespace std;
@@ -32,7 +37,8 @@ using namespace std;
 //----------------------------------------------------------------------------------------
 Diagnose::Diagnose(Initiation &ini, Hydrodynamics &hydro)
 {
-    int k, l, m;
+    int k, l;
+    ParticleStore &store = hydro.store;
         
     //copy parameters from Initiation class
     x_cells = ini.x_cells; y_cells = ini.y_cells;
@@ -46,20 +52,60 @@ Diagnose::Diagnose(Initiation &ini, Hydrodynamics &hydro)
     //the size of average region
     gridx = x_cells*hdelta + 1; gridy = y_cells*hdelta + 1;
 
-    //creat average matrix
-    U = new double **[5];
-    for(k = 0; k < 5; k++) {
-        U[k] = new double *[gridx];
-        for(l = 0; l < gridx; l++) U[k][l] = new double [gridy];
-    }
+    //the running averages, one contiguous block of all grid points
+    mean = new double [gridx*gridy*GRID_STATES];
+    M2 = new double [gridx*gridy*GRID_STATES];
+    n_samples = new int [gridx*gridy];
+    sample = new double [gridx*gridy*GRID_STATES];
+    weight = new double [gridx*gridy];
         
     //set zero initial values
-    for(k = 0; k < 5; k++)
-        for(m = 0; m < gridx; m++) 
-            for(l = 0; l < gridy; l++) U[k][m][l] = 0.0; 
+    for(l = 0; l < gridx*gridy*GRID_STATES; l++) mean[l] = M2[l] = 0.0;
+    for(l = 0; l < gridx*gridy; l++) n_samples[l] = 0;
 
     //initial zero sample number
     n_average = 0;
+    average_method = ini.average_method; average_stride = ini.average_stride;
+    average_calls = 0;
+    smoothinglength = ini.smoothinglength;
+    //the states on the grid points of the average region
+    grid = average_method == 0 ? new GridMapping(ini) : NULL;
+
+    //the tracer particles, the real particles with the given IDs
+    number_of_tracers = ini.number_of_tracers > 0 ? ini.number_of_tracers : 1;
+    tracer = new int [number_of_tracers];
+    long *tracer_ID = new long [number_of_tracers];
+    if(ini.number_of_tracers == 0) {
+        tracer[0] = 1; tracer_ID[0] = store.ID[1];
+    }
+    else {
+        for(k = 0; k < number_of_tracers; k++) {
+            tracer_ID[k] = ini.tracer_ID[k];
+            for(tracer[k] = 0; tracer[k] < store.number_of_real; tracer[k]++)
+                if(store.ID[tracer[k]] == tracer_ID[k]) break;
+            if(tracer_ID[k] <= 0 || tracer[k] == store.number_of_real) {
+                cout<<"Diagnose: no real particle has the tracer ID "<<tracer_ID[k]<<" \n";
+                std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+                exit(1);
+            }
+        }
+    }
+    if(ini.diagnose == 1) tracers.Create("./outdata/tracers.bin", number_of_tracers, tracer_ID);
+    delete[] tracer_ID;
+
+    //the time correlations of the fluid particles
+    vacf = stress_acf = NULL; fluid = NULL; velocity = NULL;
+    number_of_fluid = 0; number_of_correlations = 0; stress_sum = 0.0;
+    area = ini.box_size[0]*ini.box_size[1];
+    correlation_interval = ini.correlation_interval;
+    if(correlation_interval > 0.0) {
+        for(k = 0; k < store.number_of_real; k++) if(store.bd[k] == 0) number_of_fluid++;
+        fluid = new int [number_of_fluid];
+        for(k = 0, l = 0; k < store.number_of_real; k++) if(store.bd[k] == 0) fluid[l++] = k;
+        velocity = new double [2*number_of_fluid];
+        vacf = new Correlator(2*number_of_fluid);
+        stress_acf = new Correlator(1);
+    }
 
 
     //total mass
@@ -70,17 +116,14 @@ Diagnose::Diagnose(Initiation &ini, Hydrodynamics &hydro)
         
         ttl_m = 1.0e-40;
         for(k = 0; k < number_of_materials; k++) mtl_m[k] = 1.0e-40;
-        //iterate the partilce list
-        for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-             !hydro.particle_list.isEnd(p); 
-             p = hydro.particle_list.next(p)) {
+        //iterate the real and wall partilces
+        for(int prtl = 0; prtl < store.number_of_real; prtl++) {
                         
-            Particle *prtl = hydro.particle_list.retrieve(p);
             //find the number of the material
             for(k = 0;  k < number_of_materials; k++) 
-                if(strcmp(prtl->mtl->material_name, hydro.materials[k].material_name) == 0) 
-                    mtl_m[k] += prtl->m;
-            ttl_m += prtl->m;
+                if(strcmp(store.mtl[prtl]->material_name, hydro.materials[k].material_name) == 0) 
+                    mtl_m[k] += store.m[prtl];
+            ttl_m += store.m[prtl];
         }
 
         char file_name[50];
@@ -99,38 +142,47 @@ Diagnose::Diagnose(Initiation &ini, Hydrodynamics &hydro)
     }
 }
 //----------------------------------------------------------------------------------------
-//                                      save the states of a particle
+//                                                      destructor
 //----------------------------------------------------------------------------------------
-void Diagnose::SaveStates(Hydrodynamics &hydro)
+Diagnose::~Diagnose()
 {
-    int k;
-        
-    //select a given node on the particle list
-    LlistNode<Particle> *p = hydro.particle_list.first(); 
-    for(k = 0; k < 1; k++) p = hydro.particle_list.next(p); 
-    Particle *prtl = hydro.particle_list.retrieve(p);
-
-    //Insert the sates of the particle
-    double *p1 = new double;
-    *p1 = prtl->U[0];
-    double *p2 = new double;
-    *p2 = prtl->U[1];
-    double *p3 = new double;
-    *p3 = prtl->rho;
-        
-    vx_list.insert(vx_list.first(), p1);
-    vy_list.insert(vy_list.first(), p2);
-    rho_list.insert(rho_list.first(), p3);
+    delete grid;
+    delete[] mean; delete[] M2; delete[] n_samples;
+    delete[] sample; delete[] weight;
+    delete[] tracer;
+    delete vacf; delete stress_acf;
+    delete[] fluid; delete[] velocity;
+}
+//----------------------------------------------------------------------------------------
+//                                      save the states of the tracer particles
+//----------------------------------------------------------------------------------------
+void Diagnose::SaveStates(double Time, Hydrodynamics &hydro)
+{
+    ParticleStore &store = hydro.store;
+
+    //the trajectories
+    tracers.Record(Time, store, tracer);
+
+    //the distributions
+    for(int k = 0; k < number_of_tracers; k++) {
+        const int prtl = tracer[k];
+        vx_histogram.Add(store.U[prtl][0]);
+        vy_histogram.Add(store.U[prtl][1]);
+        rho_histogram.Add(store.rho[prtl]);
+    }
 }
 //----------------------------------------------------------------------------------------
 //                                      output distribution up to the time
 //----------------------------------------------------------------------------------------
 void Diagnose::OutputProfile(double Time, Initiation &ini)
 {
-    int k, m;
+    int m;
     double Itime;
     char file_name[150], file_list[110];
 
+    //the trajectories up to the time
+    tracers.Flush();
+
     //produce output file name
     Itime = Time*1.0e8;
     strcpy(file_name,"./outdata/dstr");
@@ -142,118 +194,150 @@ void Diagnose::OutputProfile(double Time, Initiation &ini)
     //defining header for tecplot(plot software)
     out<<"title='distributions' \n";
     out<<"variables=aUx, Ux, aUy, Uy, arho, rho \n";
-    //build the distribution
-    //clear the distribution
-    for(k = 0; k < 2; k++)
-        for(m = 0; m < 101; m++) vx_dstrb[k][m] = 0.0; 
-    BuildDistribution(vx_list, vx_dstrb);
-    for(k = 0; k < 2; k++)
-        for(m = 0; m < 101; m++) vy_dstrb[k][m] = 0.0; 
-    BuildDistribution(vy_list, vy_dstrb);
-    for(m = 0; m < 101; m++) rho_dstrb[0][m] = 1.0; 
-    for(m = 0; m < 101; m++) rho_dstrb[1][m] = 0.0; 
-    BuildDistribution(rho_list, rho_dstrb);
-
-    //normalize to unit
-    k =  vx_list.length();
-    for(m = 0; m < 101; m++) {
-        out<<vx_dstrb[0][m]<<"  "<<vx_dstrb[1][m]/double(k)<<"  "
-           <<vy_dstrb[0][m]<<"  "<<vy_dstrb[1][m]/double(k)<<"  "
-           <<rho_dstrb[0][m]<<"  "<<rho_dstrb[1][m]/double(k)<<"  \n";
+
+    //the bin centers and the fractions of the samples
+    for(m = 0; m < HISTOGRAM_BINS; m++) {
+        out<<vx_histogram.Center(m)<<"  "<<vx_histogram.Fraction(m)<<"  "
+           <<vy_histogram.Center(m)<<"  "<<vy_histogram.Fraction(m)<<"  "
+           <<rho_histogram.Center(m)<<"  "<<rho_histogram.Fraction(m)<<"  \n";
     }
 }
 //----------------------------------------------------------------------------------------
-//                                                      biuld distribution
+//                      add the states of a sample to the running mean
 //----------------------------------------------------------------------------------------
-void Diagnose::BuildDistribution(Llist<double> &list, double dstrb[2][101])
+void Diagnose::AddSample(int n, const double *state)
 {
-    int m;
+    double *mn = mean + n*GRID_STATES, *m2 = M2 + n*GRID_STATES;
 
-    //claculate the maximum and the minimum
-    for (LlistNode<double> *p = list.first(); 
-         !list.isEnd(p); p = list.next(p)) {
-        dstrb[0][0] = AMIN1(dstrb[0][0], *list.retrieve(p));
-        dstrb[0][100] = AMAX1(dstrb[0][100], *list.retrieve(p));        
+    //Welford's update of the mean and the sum of squared deviations
+    const double m_n_average = double(n_samples[n]); 
+    const double r_n_average = 1.0/double(++n_samples[n]);
+    for(int k = 0; k < GRID_STATES; k++) {
+        const double deviation = state[k] - mn[k];
+        mn[k] = (mn[k]*m_n_average + state[k])*r_n_average;
+        m2[k] += deviation*(state[k] - mn[k]);
     }
+}
+//----------------------------------------------------------------------------------------
+//              bin or deposit the particle states to the grid points
+//----------------------------------------------------------------------------------------
+void Diagnose::Deposit(ParticleManager &particles, QuinticSpline &weight_function)
+{
+    int i, j, k, l, n;
+    ParticleStore &store = particles.store;
+    //number of different grid points in the periodic directions
+    const int x_period = store.period[0] > 0.0 ? gridx - 1 : 0;
+    const int y_period = store.period[1] > 0.0 ? gridy - 1 : 0;
+    double state[GRID_STATES];
 
-    //biuld x axes
-    double delta;
-    delta = (dstrb[0][100] - dstrb[0][0])*0.01;
-    for(m = 0; m < 101; m++) dstrb[0][m] = dstrb[0][0] + delta*(double)m;
+    for(l = 0; l < gridx*gridy*GRID_STATES; l++) sample[l] = 0.0;
+    for(l = 0; l < gridx*gridy; l++) weight[l] = 0.0;
 
-    //locate the states
-    for (LlistNode<double> *p1 = list.first(); 
-         !list.isEnd(p1); p1 = list.next(p1)) {
+    //binning: the real particles to the nearest grid point
+    if(average_method == 1) {
+        for(int prtl = 0; prtl < store.number_of_real; prtl++) {
+            i = int(floor(store.R[prtl][0]/delta + 0.5));
+            j = int(floor(store.R[prtl][1]/delta + 0.5));
+            if(x_period) i = (i%x_period + x_period)%x_period;
+            if(y_period) j = (j%y_period + y_period)%y_period;
+            if(i < 0) i = 0; 
+            if(i > gridx - 1) i = gridx - 1;
+            if(j < 0) j = 0; 
+            if(j > gridy - 1) j = gridy - 1;
 
-        //where is the particle
-        m = int ((*list.retrieve(p1) - dstrb[0][0]) / delta);
-        dstrb[1][m] += 1.0;
+            n = j*gridx + i;
+            state[GRID_P] = store.p[prtl]; state[GRID_RHO] = store.rho[prtl];
+            state[GRID_PHI] = store.Phi(prtl)[2*number_of_materials + 2];
+            state[GRID_UX] = store.U[prtl][0]; state[GRID_UY] = store.U[prtl][1];
+            state[GRID_T] = store.T[prtl];
+            for(k = 0; k < GRID_STATES; k++) sample[n*GRID_STATES + k] += state[k];
+            weight[n] += 1.0;
+        }
     }
+
+    //deposition: all particles, the images included, to the grid points in the kernel support
+    if(average_method == 2) {
+        for(int prtl = 0; prtl < store.number_of_particles; prtl++) {
+            const double x = store.R[prtl][0], y = store.R[prtl][1];
+            const double V = store.m[prtl]/store.rho[prtl];
+            state[GRID_P] = store.p[prtl]; state[GRID_RHO] = store.rho[prtl];
+            state[GRID_PHI] = store.Phi(prtl)[2*number_of_materials + 2];
+            state[GRID_UX] = store.U[prtl][0]; state[GRID_UY] = store.U[prtl][1];
+            state[GRID_T] = store.T[prtl];
+
+            for(int jj = int(ceil((y - smoothinglength)/delta)); jj*delta < y + smoothinglength; jj++) {
+                j = y_period ? (jj%y_period + y_period)%y_period : jj;
+                if(j < 0 || j >= gridy) continue;
+                for(int ii = int(ceil((x - smoothinglength)/delta)); ii*delta < x + smoothinglength; ii++) {
+                    i = x_period ? (ii%x_period + x_period)%x_period : ii;
+                    if(i < 0 || i >= gridx) continue;
+
+                    const double r = sqrt(sqr(ii*delta - x) + sqr(jj*delta - y));
+                    if(r >= smoothinglength) continue;
+                    const double w = weight_function.w(r)*V;
+                    n = j*gridx + i;
+                    for(k = 0; k < GRID_STATES; k++) sample[n*GRID_STATES + k] += state[k]*w;
+                    weight[n] += w;
+                }
+            }
+        }
+    }
+
+    //the last grid points of the periodic directions are the first ones
+    if(x_period)
+        for(j = 0; j < gridy; j++) {
+            n = j*gridx;
+            for(k = 0; k < GRID_STATES; k++) sample[(n + x_period)*GRID_STATES + k] = sample[n*GRID_STATES + k];
+            weight[n + x_period] = weight[n];
+        }
+    if(y_period)
+        for(i = 0; i < gridx; i++) {
+            n = i;
+            for(k = 0; k < GRID_STATES; k++) sample[(n + y_period*gridx)*GRID_STATES + k] = sample[n*GRID_STATES + k];
+            weight[n + y_period*gridx] = weight[n];
+        }
 }
 //----------------------------------------------------------------------------------------
 //                                              calculate the average values
 //----------------------------------------------------------------------------------------
 void Diagnose::Average(ParticleManager &particles, MLS &mls, QuinticSpline &weight_function, Initiation &ini)
 {
-    int i, j, n;
-    Vec2d pstn;
-    double rho, pressure, Temperature, x_velocity, y_velocity;
-    double m_n_average, r_n_average;
+    int i, j, k, n;
+    double state[GRID_STATES];
+
+    //a sample every average_stride-th time step
+    if(average_calls++ % average_stride != 0) return;
 
     //one time more for average
     n_average ++;
-        
-    //loop the grid points
-    //NOTE: loop the x direction first and then the y direction!
-    for(j = 0; j < gridy; j++) { 
-        for(i = 0; i < gridx; i++) {
-            pstn[0] = i*delta; pstn[1] = j*delta;
-            //biuld the NNP_list
-            particles.BuildNNP(pstn);
-            //if the NNP list is not empty run MLS approximation
-            if(!particles.NNP_list.empty()) 
-                mls.MLSMapping(pstn, particles.NNP_list, weight_function, 1);
-            n = 0;
-            rho = 0.0; pressure = 0.0; Temperature = 0.0;
-            x_velocity = 0.0; y_velocity = 0.0;
-            //iterate this Nearest Neighbor Particle list
-            for (LlistNode<Particle> *p = particles.NNP_list.first(); 
-                 !particles.NNP_list.isEnd(p); 
-                 p = particles.NNP_list.next(p)) {
-                        
-                //get particle data
-                Particle *prtl = particles.NNP_list.retrieve(p);
-                rho += prtl->rho*mls.phi[n];
-                pressure += prtl->p*mls.phi[n];
-                Temperature += prtl->T*mls.phi[n];
-                x_velocity += prtl->U[0]*mls.phi[n];
-                y_velocity += prtl->U[1]*mls.phi[n];
-                                
-                n ++;
-            }
-            //clear the NNP_list
-            particles.NNP_list.clear();
-                
-            //calculating the averages
-            m_n_average = double(n_average) - 1.0; 
-            r_n_average = 1.0/double(n_average);
-            U[0][i][j] = (U[0][i][j]*m_n_average + rho)*r_n_average;
-            U[1][i][j] = (U[1][i][j]*m_n_average + pressure)*r_n_average;
-            U[2][i][j] = (U[2][i][j]*m_n_average + Temperature)*r_n_average;
-            U[3][i][j] = (U[3][i][j]*m_n_average + x_velocity)*r_n_average;
-            U[4][i][j] = (U[4][i][j]*m_n_average + y_velocity)*r_n_average;
-        }
+
+    //the states on the grid points
+    if(average_method == 0) {
+        grid->Map(particles, weight_function, 1);
+        for(j = 0; j < gridy; j++) 
+            for(i = 0; i < gridx; i++) AddSample(j*gridx + i, grid->State(i, j));
+        return;
     }
+
+    //the binned or deposited states, the grid points without particles have no sample
+    Deposit(particles, weight_function);
+    for(n = 0; n < gridx*gridy; n++) 
+        if(weight[n] > 0.0) {
+            for(k = 0; k < GRID_STATES; k++) state[k] = sample[n*GRID_STATES + k]/weight[n];
+            AddSample(n, state);
+        }
 }
 //----------------------------------------------------------------------------------------
 //                                                      output the average values
 //----------------------------------------------------------------------------------------
 void Diagnose::OutputAverage(double Time, Initiation &ini)
 {
-    int i, j;
+    int i, j, k;
     Vec2d pstn;
     double Itime;
     char file_name[150], file_list[110];
+    //the columns of the states
+    const int column[5] = {GRID_P, GRID_RHO, GRID_UX, GRID_UY, GRID_T};
         
     //produce output file name
     Itime = Time*1.0e8;
@@ -264,7 +348,7 @@ void Diagnose::OutputAverage(double Time, Initiation &ini)
     ofstream out(file_name);
     //defining header for tecplot(plot software)
     out<<"title=averaged states with '"<<n_average<<"' samples' \n";
-    out<<"variables=x, y, p, rho, Ux, Uy, T \n";
+    out<<"variables=x, y, p, rho, Ux, Uy, T, dp, drho, dUx, dUy, dT \n";
     out<<"zone t='filed', i="<<gridx<<", j="<<gridy<<"\n";
 
     //loop the grid points
@@ -272,11 +356,16 @@ void Diagnose::OutputAverage(double Time, Initiation &ini)
     for(j = 0; j < gridy; j++) { 
         for(i = 0; i < gridx; i++) {
             pstn[0] = i*delta; pstn[1] = j*delta;
+            const int n = j*gridx + i;
 
-            out<<pstn[0]<<"  "<<pstn[1]
-               <<"  "<<U[1][i][j]<<"  "<<U[0][i][j]
-               <<"  "<<U[3][i][j]<<"  "<<U[4][i][j]
-               <<"  "<<U[2][i][j]<<"\n";
+            out<<pstn[0]<<"  "<<pstn[1];
+            //the means
+            for(k = 0; k < 5; k++) out<<"  "<<mean[n*GRID_STATES + column[k]];
+            //the standard errors of the means
+            for(k = 0; k < 5; k++) 
+                out<<"  "<<(n_samples[n] > 1 ? 
+                            sqrt(M2[n*GRID_STATES + column[k]]/(double(n_samples[n])*(n_samples[n] - 1))) : 0.0);
+            out<<"\n";
         }
     }
     out.close();
@@ -288,6 +377,7 @@ void Diagnose::KineticInformation(double Time, Initiation &ini, Hydrodynamics &h
 {
     int k;
     char file_name[150];
+    ParticleStore &store = hydro.store;
 
     //produce output file name
     strcpy(file_name,"./outdata/kinetic_info.dat");
@@ -298,19 +388,16 @@ void Diagnose::KineticInformation(double Time, Initiation &ini, Hydrodynamics &h
         (wght_v[k]) = 0.0;
     }
     glb_ave_Ek = 0.0;
-    //iterate the partilce list
-    for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-         !hydro.particle_list.isEnd(p); 
-         p = hydro.particle_list.next(p)) {
+    //iterate the real and wall partilces
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
                         
-        Particle *prtl = hydro.particle_list.retrieve(p);
         //find the number of the material
         for(k = 0;  k < number_of_materials; k++) 
-            if(strcmp(prtl->mtl->material_name, hydro.materials[k].material_name) == 0) {
-                wght_cntr[k] += prtl->R*prtl->m;
-                wght_v[k] += prtl->U*prtl->m;
+            if(strcmp(store.mtl[prtl]->material_name, hydro.materials[k].material_name) == 0) {
+                wght_cntr[k] += store.R[prtl]*store.m[prtl];
+                wght_v[k] += store.U[prtl]*store.m[prtl];
             }
-        glb_ave_Ek += 0.5*sqr(v_abs(prtl->U))*prtl->m;
+        glb_ave_Ek += 0.5*sqr(v_abs(store.U[prtl]))*store.m[prtl];
     }
 
     out<<Time<<"  "<<ttl_m<<"  "<<glb_ave_Ek<<"  ";
@@ -322,4 +409,82 @@ void Diagnose::KineticInformation(double Time, Initiation &ini, Hydrodynamics &h
     out.close();
 
 }
+//----------------------------------------------------------------------------------------
+//              sample the velocity and the xy stress for their autocorrelations
+//----------------------------------------------------------------------------------------
+void Diagnose::Correlation(double Time, Hydrodynamics &hydro)
+{
+    int k;
+    ParticleStore &store = hydro.store;
+
+    //no pair forces to take the stress from
+    if(hydro.NumberOfPairs() == 0) return;
+
+    //a sample at the first time step at or after each multiple of the interval 
+    //from the first sample, the time steps must not skip a multiple
+    if(number_of_correlations > 0) {
+        const double next_correlation = first_correlation + double(number_of_correlations)*correlation_interval;
+        if(Time < next_correlation) return;
+        if(Time >= next_correlation + correlation_interval) {
+            cout<<"Diagnose: the time step is longer than the correlation interval! \n";
+            std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+            exit(1);
+        }
+    }
+
+    //the velocities of the fluid particles relative to their center of mass
+    Vec2d U_c = 0.0;
+    double m_c = 1.0e-40;
+    for(k = 0; k < number_of_fluid; k++) {
+        U_c += store.U[fluid[k]]*store.m[fluid[k]];
+        m_c += store.m[fluid[k]];
+    }
+    U_c = U_c/m_c;
+    for(k = 0; k < number_of_fluid; k++) {
+        velocity[2*k] = store.U[fluid[k]][0] - U_c[0];
+        velocity[2*k + 1] = store.U[fluid[k]][1] - U_c[1];
+    }
+    vacf->Add(velocity);
+
+    //the xy stress of the fluid from the kinetic part and the virial of the forces
+    double stress = 0.0;
+    for(k = 0; k < number_of_fluid; k++) 
+        stress += store.m[fluid[k]]*store.U[fluid[k]][0]*store.U[fluid[k]][1];
+    stress = - (stress + hydro.ShearVirial())/area;
+    stress_acf->Add(&stress);
+    stress_sum += stress;
+
+    if(number_of_correlations == 0) first_correlation = Time;
+    number_of_correlations++;
+}
+//----------------------------------------------------------------------------------------
+//              output the autocorrelations and the Green-Kubo integral of the stress
+//----------------------------------------------------------------------------------------
+void Diagnose::OutputCorrelation(double Time)
+{
+    int l, j;
+    double lag, C_v, C_xy, tau_before = 0.0, C_before = 0.0, integral = 0.0;
+
+    //the autocorrelation of the stress fluctuation
+    const double mean_stress = number_of_correlations > 0 ? stress_sum/double(number_of_correlations) : 0.0;
+
+    ofstream out("./outdata/correlation.dat");
+    //defining header for tecplot(plot software)
+    out<<"title='time correlations with "<<number_of_correlations<<" samples up to "<<Time<<"' \n";
+    out<<"variables=tau, vacf, sxy_acf, A*int(sxy_acf) \n";
+
+    //the lags in increasing order
+    for(l = 0; l < vacf->Levels(); l++)
+        for(j = 0; j < CORRELATOR_POINTS; j++) {
+            if(!vacf->Result(l, j, lag, C_v) || !stress_acf->Result(l, j, lag, C_xy)) continue;
+            const double tau = lag*correlation_interval;
+            C_xy -= mean_stress*mean_stress;
 
+            //trapezoidal rule
+            if(tau > 0.0) integral += 0.5*(C_before + C_xy)*(tau - tau_before);
+            tau_before = tau; C_before = C_xy;
+
+            out<<tau<<"  "<<C_v/double(number_of_fluid)<<"  "<<C_xy<<"  "<<area*integral<<"\n";
+        }
+    out.close();
+}
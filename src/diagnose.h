@@ -4,11 +4,16 @@
 #ifndef DIAGNOSE_H
 #define DIAGNOSE_H
 
+#include "histogram.h"
+#include "tracerfile.h"
+
 class Hydrodynamics;
 class Initiation;
 class ParticleManager; 
 class QuinticSpline;
 class MLS;
+class GridMapping;
+class Correlator;
 
 /// Output diagnosal 
 class Diagnose {
@@ -23,18 +28,43 @@ class Diagnose {
     char Project_name[125];
     int number_of_materials;
 
-    ///velocity, density, distributions
-    double vx_dstrb[2][101], vy_dstrb[2][101], rho_dstrb[2][101];
-    ///list for states of a given particle
-    Llist<double> vx_list, vy_list, rho_list; 
+    ///velocity, density, distributions of the tracers
+    Histogram vx_histogram, vy_histogram, rho_histogram;
+    ///the tracer particles and their trajectories
+    int number_of_tracers, *tracer;
+    TracerRecorder tracers;
 
     ///average profile mesh size
     int gridx, gridy;
-    double ***U;
     int n_average; ///the times of average
+    ///mapping of the particle states to the grid points
+    GridMapping *grid;
+
+    ///sampling of the averages, 0: MLS mapping, 1: binning, 2: kernel deposition
+    int average_method, average_stride;
+    ///number of calls of Average, a sample every average_stride-th call
+    int average_calls;
+    double smoothinglength;
+    ///running mean and sum of squared deviations (Welford) of the GRID_STATES values
+    ///of grid point (i, j) at [(j*gridx + i)*GRID_STATES], and its number of samples
+    double *mean, *M2;
+    int *n_samples;
+    ///sums of the binned or deposited states of one sample and their weights
+    double *sample, *weight;
+
+    ///add the particle states to the sample sums, binned or deposited with the kernel
+    void Deposit(ParticleManager &particles, QuinticSpline &weight_function);
+    ///add the states of a sample to the running mean of grid point n
+    void AddSample(int n, const double *state);
 
-    ///biuld distribution
-    void BuildDistribution(Llist<double> &list, double dstrb[2][101]);
+    ///velocity autocorrelation of the fluid particles and autocorrelation of the xy stress
+    Correlator *vacf, *stress_acf;
+    int number_of_fluid, *fluid;
+    double *velocity;
+    ///area of the domain, time between the samples, time of the first sample, 
+    ///sum of the stress samples and number of samples
+    double area, correlation_interval, first_correlation, stress_sum;
+    long long number_of_correlations;
 
     ///total mass, global average kinetic energy, material weight center position and velocity
     double ttl_m, *mtl_m, glb_ave_Ek;
@@ -44,9 +74,11 @@ public:
 
     ///constructor
     Diagnose(Initiation &ini, Hydrodynamics &hydro);
+    ///destructor
+    ~Diagnose();
 
-    ///save the states of a particle
-    void SaveStates(Hydrodynamics &hydro);
+    ///save the states of the tracer particles
+    void SaveStates(double Time, Hydrodynamics &hydro);
     ///output distribution up to the time
     void OutputProfile(double Time, Initiation &ini);
 
@@ -57,6 +89,11 @@ public:
 
     ///track the globle average kinetic energy, weight center position and velocity
     void KineticInformation(double Time, Initiation &ini, Hydrodynamics &hydro);
+    ///sample the velocity and the xy stress for their autocorrelations, right after the change
+    ///rates, so that the stress uses the pairs and the states of the forces; Time is their time
+    void Correlation(double Time, Hydrodynamics &hydro);
+    ///output the autocorrelations and the Green-Kubo integral of the stress
+    void OutputCorrelation(double Time);
 };
 
 #endif
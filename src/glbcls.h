@@ -15,6 +15,7 @@
 #include "vec2d.h"
 #include "wiener.h"
 #include "dllist.h"
+#include "particlestore.h"
 
 //class Initiation; class Kernel; class MLS; class Interaction; class ParticleManager;
 //class Particle; class Initiation; class Boundary; class Force; class Output; class Diagnose;
@@ -24,7 +25,6 @@
 /* #include "kernel.h" */
 /* #include "betaspline.h" */
 /* #include "quinticspline.h" */
-/* #include "particle.h" */
 /* #include "particlemanager.h" */
 /* #include "boundary.h" */
 /* #include "material.h" */
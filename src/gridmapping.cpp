@@ -0,0 +1,155 @@
+// gridmapping.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Mapping of the particle states to the uniform output grid
+//              gridmapping.cpp
+//----------------------------------------------------------------------------------------
+
+#include <iostream>
+
+#include <cstdlib>
+#include <cmath>
+
+// ***** localincludes *****
+#include "glbcls.h"
+#include "glbfunc.h"
+#include "gridmapping.h"
+#include "particlemanager.h"
+#include "mls.h"
+#include "initiation.h"
+#include "quinticspline.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+GridMapping::GridMapping(Initiation &ini)
+{
+    gridx = ini.x_cells*ini.hdelta; gridy = ini.y_cells*ini.hdelta;
+    delta = ini.delta;
+    smoothinglength = ini.smoothinglength;
+    cell_size = ini.cell_size;
+    number_of_materials = ini.number_of_materials;
+
+    states = new double[(gridx + 1)*(gridy + 1)*GRID_STATES];
+    SortNodes(ini.x_cells, ini.y_cells);
+
+#ifdef _OPENMP
+    number_of_threads = omp_get_max_threads();
+#else
+    number_of_threads = 1;
+#endif
+    mls = new MLS *[number_of_threads];
+    candidates = new int *[number_of_threads];
+    neighbours = new int *[number_of_threads];
+    candidate_capacity = new int[number_of_threads];
+    neighbour_capacity = new int[number_of_threads];
+    for(int t = 0; t < number_of_threads; t++) {
+        mls[t] = new MLS(ini);
+        candidate_capacity[t] = neighbour_capacity[t] = 256;
+        candidates[t] = new int[candidate_capacity[t]];
+        neighbours[t] = new int[neighbour_capacity[t]];
+    }
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+GridMapping::~GridMapping()
+{
+    for(int t = 0; t < number_of_threads; t++) {
+        delete mls[t];
+        delete[] candidates[t]; delete[] neighbours[t];
+    }
+    delete[] mls; delete[] candidates; delete[] neighbours;
+    delete[] candidate_capacity; delete[] neighbour_capacity;
+    delete[] x_first; delete[] y_first;
+    delete[] states;
+}
+//----------------------------------------------------------------------------------------
+//              sort the grid nodes into the cells, the same cells as in the NNP search
+//----------------------------------------------------------------------------------------
+void GridMapping::SortNodes(int x_cells, int y_cells)
+{
+    int i, k;
+
+    //the boundary cells included
+    x_clls = x_cells + 2; y_clls = y_cells + 2;
+    x_first = new int[x_clls + 1];
+    y_first = new int[y_clls + 1];
+
+    //the nodes are sorted along each direction, the cells of the nodes do not decrease
+    for(k = 0, i = 0; k <= x_clls; k++) {
+        while(i <= gridx && int ((i*delta + cell_size)/ cell_size) < k) i++;
+        x_first[k] = i;
+    }
+    for(k = 0, i = 0; k <= y_clls; k++) {
+        while(i <= gridy && int ((i*delta + cell_size)/ cell_size) < k) i++;
+        y_first[k] = i;
+    }
+}
+//----------------------------------------------------------------------------------------
+//                      map the states of the particles to all grid nodes
+//----------------------------------------------------------------------------------------
+void GridMapping::Map(ParticleManager &particles, QuinticSpline &weight_function, int order)
+{
+    int m;
+    ParticleStore &store = particles.store;
+
+    //the rows of cells in parallel, the cells have different numbers of particles
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(m = 0; m < y_clls; m++) {
+        int this_thread_num = 0;
+#ifdef _OPENMP
+        this_thread_num = omp_get_thread_num();
+#endif
+        MLS &approximation = *mls[this_thread_num];
+        int *&candidate = candidates[this_thread_num];
+        int *&neighbour = neighbours[this_thread_num];
+        Vec2d pstn;
+
+        for(int k = 0; k < x_clls; k++) {
+            if(x_first[k] == x_first[k + 1] || y_first[m] == y_first[m + 1]) continue;
+
+            //the candidates of all nodes in the cell
+            const int number = particles.CellNeighbours(k, m, candidate, candidate_capacity[this_thread_num]);
+            if(number > neighbour_capacity[this_thread_num]) {
+                delete[] neighbour;
+                neighbour_capacity[this_thread_num] = candidate_capacity[this_thread_num];
+                neighbour = new int[neighbour_capacity[this_thread_num]];
+            }
+
+            for(int j = y_first[m]; j < y_first[m + 1]; j++)
+                for(int i = x_first[k]; i < x_first[k + 1]; i++) {
+                    pstn[0] = i*delta; pstn[1] = j*delta;
+
+                    //the neighbours of the node
+                    int n, NNP_number = 0;
+                    for(n = 0; n < number; n++)
+                        if(v_abs(store.Wrap(pstn - store.R[candidate[n]])) < smoothinglength)
+                            neighbour[NNP_number++] = candidate[n];
+
+                    //if the neighbour list is not empty run MLS approximation
+                    if(NNP_number > 0)
+                        approximation.MLSMapping(pstn, store, neighbour, NNP_number, weight_function, order);
+
+                    double *state = states + (j*(gridx + 1) + i)*GRID_STATES;
+                    for(n = 0; n < GRID_STATES; n++) state[n] = 0.0;
+                    for(n = 0; n < NNP_number; n++) {
+                        const int prtl = neighbour[n];
+                        const double phi = approximation.phi[n];
+                        state[GRID_RHO] += store.rho[prtl]*phi;
+                        state[GRID_PHI] += store.Phi(prtl)[2*number_of_materials + 2]*phi;
+                        state[GRID_P] += store.p[prtl]*phi;
+                        state[GRID_T] += store.T[prtl]*phi;
+                        state[GRID_UX] += store.U[prtl][0]*phi;
+                        state[GRID_UY] += store.U[prtl][1]*phi;
+                    }
+                }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/// \file gridmapping.h
+/// \brief Mapping of the particle states to the uniform output grid
+
+#ifndef GRIDMAPPING_H
+#define GRIDMAPPING_H
+
+class Initiation;
+class ParticleManager;
+class QuinticSpline;
+class MLS;
+
+///states on a grid node
+enum { GRID_P, GRID_RHO, GRID_PHI, GRID_UX, GRID_UY, GRID_T, GRID_STATES };
+
+/// Mapping of the particle states to the uniform output grid by MLS
+///
+/// The grid nodes are processed cell by cell: the particles of the cell and its
+/// surrounding cells are collected once and are the candidates of all grid nodes
+/// in the cell. The rows of cells are mapped in parallel, each thread with its own
+/// MLS approximation and lists. A node gets the same neighbours in the same order as
+/// from ParticleManager::ForNeighbours, so the states are the same as mapped node by node.
+class GridMapping {
+
+    ///number of grid intervals, the nodes are (0 ... gridx)*delta x (0 ... gridy)*delta
+    int gridx, gridy;
+    double delta;
+    double smoothinglength, cell_size;
+    int number_of_materials;
+
+    ///the nodes of cell column k are x_first[k] ... x_first[k + 1] - 1,
+    ///the nodes of cell row m are y_first[m] ... y_first[m + 1] - 1
+    int *x_first, *y_first;
+    ///number of cell columns and rows of the node lists
+    int x_clls, y_clls;
+
+    ///per thread: MLS approximation, the candidates of a cell and the neighbours of a node
+    int number_of_threads;
+    MLS **mls;
+    int **candidates, *candidate_capacity;
+    int **neighbours, *neighbour_capacity;
+
+    ///sort the grid nodes into the cells
+    void SortNodes(int x_cells, int y_cells);
+
+public:
+
+    ///states of the grid nodes, the GRID_STATES values of node (i, j)
+    ///start at states[(j*(gridx + 1) + i)*GRID_STATES]
+    double *states;
+
+    ///constructor
+    GridMapping(Initiation &ini);
+    ///destructor
+    ~GridMapping();
+
+    ///number of grid intervals in x and y
+    int GridX() const { return gridx; }
+    int GridY() const { return gridy; }
+    ///the states of node (i, j)
+    const double *State(int i, int j) const { return states + (j*(gridx + 1) + i)*GRID_STATES; }
+
+    ///map the states of the particles to all grid nodes with MLS of the given order
+    void Map(ParticleManager &particles, QuinticSpline &weight_function, int order);
+};
+
+#endif
@@ -0,0 +1,68 @@
+// histogram.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Online histogram with a fixed number of bins
+//              histogram.cpp
+//----------------------------------------------------------------------------------------
+
+#include <cmath>
+
+// ***** localincludes *****
+#include "histogram.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+Histogram::Histogram():
+lower(0.0), width(0.0), total(0)
+{
+    for(int m = 0; m < HISTOGRAM_BINS; m++) count[m] = 0;
+}
+//----------------------------------------------------------------------------------------
+//                                      double the bin width
+//----------------------------------------------------------------------------------------
+void Histogram::Widen(int upper)
+{
+    int m;
+    const int half = HISTOGRAM_BINS/2;
+
+    if(upper) {
+        //the old range becomes the upper half
+        for(m = HISTOGRAM_BINS - 1; m >= half; m--) 
+            count[m] = count[2*(m - half)] + count[2*(m - half) + 1];
+        for(m = 0; m < half; m++) count[m] = 0;
+        lower -= HISTOGRAM_BINS*width;
+    }
+    else {
+        //the old range becomes the lower half
+        for(m = 0; m < half; m++) count[m] = count[2*m] + count[2*m + 1];
+        for(m = half; m < HISTOGRAM_BINS; m++) count[m] = 0;
+    }
+    width *= 2.0;
+}
+//----------------------------------------------------------------------------------------
+//                                      count a sample
+//----------------------------------------------------------------------------------------
+void Histogram::Add(double x)
+{
+    //not a finite number
+    if(!(fabs(x) < 1.0e300)) return;
+
+    //a narrow range around the first sample
+    if(total == 0) {
+        width = 1.0e-6*(x != 0.0 ? fabs(x) : 1.0);
+        lower = x - 0.5*HISTOGRAM_BINS*width;
+    }
+
+    while(x < lower) Widen(1);
+    while(x >= lower + HISTOGRAM_BINS*width) Widen(0);
+
+    int m = int((x - lower)/width);
+    if(m > HISTOGRAM_BINS - 1) m = HISTOGRAM_BINS - 1;
+    count[m]++;
+    total++;
+}
@@ -0,0 +1,40 @@
+/// \file histogram.h
+/// \brief Online histogram with a fixed number of bins
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+enum { HISTOGRAM_BINS = 100 };
+
+/// Online histogram with a fixed number of bins
+///
+/// A sample is counted in O(1). The range of the bins starts around the first
+/// sample and is doubled when a sample falls outside it, the pairs of bins are
+/// merged to the new bins, so the bins always cover all samples with the same
+/// memory. A doubling costs the number of bins, only a few happen in a run.
+class Histogram {
+
+    ///lower end and width of the bins
+    double lower, width;
+    ///samples in each bin and all samples
+    long long count[HISTOGRAM_BINS], total;
+
+    ///double the bin width, the old bins become the lower (upper = 0) or upper (upper = 1) half
+    void Widen(int upper);
+
+public:
+
+    ///constructor
+    Histogram();
+
+    ///count a sample
+    void Add(double x);
+    ///number of all samples
+    long long Total() const { return total; }
+    ///center of bin m
+    double Center(int m) const { return lower + (m + 0.5)*width; }
+    ///fraction of the samples in bin m
+    double Fraction(int m) const { return total > 0 ? double(count[m])/double(total) : 0.0; }
+};
+
+#endif
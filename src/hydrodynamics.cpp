@@ -18,13 +18,13 @@
 // ***** localincludes *****
 #include "glbcls.h"
 #include "glbfunc.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
 #include "initiation.h"
 #include "material.h"
 #include "force.h"
-#include "particle.h"
 #include "particlemanager.h"
-#include "interaction.h"
 #include "boundary.h"
 #include "quinticspline.h"
 #include "mls.h"
@@ -35,7 +35,7 @@ using namespace std;
 //                                              constructor
 //----------------------------------------------------------------------------------------
 Hydrodynamics::Hydrodynamics(ParticleManager &particles, Initiation &ini):
-ini(ini) {
+interaction_list(particles.store, ini), bonds(particles.store, ini), ini(ini), store(particles.store) {
         
     int k, m;
     int l, n;
@@ -103,6 +103,14 @@ ini(ini) {
                 }
     }
     fin.close();
+
+    //the Wiener increments start from the first counter
+    random_step = 0;
+
+    //the FENE bonds in sub steps
+    respa_steps = ini.respa_steps;
+    bond_dUdt_length = 0;
+    bond_dUdt = 0;
         
     //for time step and the artificial compressiblity
     viscosity_max = 0.0; surface_max = 0.0;
@@ -134,25 +142,28 @@ ini(ini) {
 void Hydrodynamics::BuildPair(ParticleManager &particles, QuinticSpline &weight_function)
 {
     //obtain the interaction pairs
-    particles.BuildInteraction(interaction_list, particle_list, forces, weight_function, ini);
-
+    particles.BuildInteraction(interaction_list, forces, weight_function);
+    //the pair values
+    interaction_list.Sweep<Interaction::Renew>();
+}
+//----------------------------------------------------------------------------------------
+//                      find the FENE bonds between the polymer beads
+//                      the bonds use the nearest image in the periodic directions
+//----------------------------------------------------------------------------------------
+void Hydrodynamics::BuildBonds(Boundary &boundary)
+{
+    Vec2d period = 0.0;
+    if(boundary.xBl == 1 && boundary.xBr == 1) period[0] = ini.box_size[0];
+    if(boundary.yBd == 1 && boundary.yBu == 1) period[1] = ini.box_size[1];
+    bonds.Build(period);
 }
 //----------------------------------------------------------------------------------------
 //                                              update new parameters in pairs
 //----------------------------------------------------------------------------------------
-void Hydrodynamics::UpdatePair(QuinticSpline &weight_function)
+void Hydrodynamics::UpdatePair()
 {
-
     //iterate the interaction list
-    for (LlistNode<Interaction> *p = interaction_list.first(); 
-         !interaction_list.isEnd(p); 
-         p = interaction_list.next(p)) {
-
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p);
-        //renew pair parameters
-        pair->RenewInteraction(weight_function);
-    }
+    interaction_list.Sweep<Interaction::Renew>();
 }
 //----------------------------------------------------------------------------------------
 //              summation for particles density and shear rates with updating interaction list
@@ -161,20 +172,12 @@ void Hydrodynamics::UpdateShearRate(ParticleManager &particles, QuinticSpline &w
 {       
 
     //obtain the interaction pairs
-    particles.BuildInteraction(interaction_list, particle_list, forces, weight_function, ini);
+    particles.BuildInteraction(interaction_list, forces, weight_function);
         
     //initiate zero shear rate
     Zero_ShearRate();
-    //iterate the interaction list
-    for (LlistNode<Interaction> *p2 = interaction_list.first(); 
-         !interaction_list.isEnd(p2); 
-         p2 = interaction_list.next(p2)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p2);
-        //calculate the pair forces or change rate
-        pair->SummationShearRate();
-    }
+    //iterate the interaction list, the pair values are computed in the same sweep
+    interaction_list.Sweep<Interaction::Renew, Interaction::ShearRate>();
 
 }
 //----------------------------------------------------------------------------------------
@@ -186,15 +189,7 @@ void Hydrodynamics::UpdatePhaseGradient(Boundary &boundary)
     //initiate zero shear rate
     Zero_PhaseGradient(boundary);
     //iterate the interaction list
-    for (LlistNode<Interaction> *p2 = interaction_list.first(); 
-         !interaction_list.isEnd(p2); 
-         p2 = interaction_list.next(p2)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p2);
-        //calculate the pair forces or change rate
-        pair->SummationPhaseGradient();
-    }
+    interaction_list.Sweep<Interaction::PhaseGradient>();
 }
 //----------------------------------------------------------------------------------------
 //              summation Phase Divergen
@@ -204,15 +199,7 @@ void Hydrodynamics::UpdatePhaseLaplacian(Boundary &boundary)
     //initiate zero shear rate
     Zero_PhaseLaplacian(boundary);
     //iterate the interaction list
-    for (LlistNode<Interaction> *p2 = interaction_list.first(); 
-         !interaction_list.isEnd(p2); 
-         p2 = interaction_list.next(p2)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p2);
-        //calculate the pair forces or change rate
-        pair->SummationPhaseLaplacian();
-    }
+    interaction_list.Sweep<Interaction::PhaseLaplacian>();
 }
 //----------------------------------------------------------------------------------------
 //              summation for pahse field gradient
@@ -222,16 +209,8 @@ void Hydrodynamics::UpdatePhaseField(Boundary &boundary)
     //initiate zero shear rate
     Zero_PhaseField(boundary);
     //iterate the interaction list
-    for (LlistNode<Interaction> *p2 = interaction_list.first(); 
-         !interaction_list.isEnd(p2); 
-         p2 = interaction_list.next(p2)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p2);
-        //calculate the pair forces or change rate
-        pair->SummationPhaseField();
-        //                      pair->SummationCurvature();
-    }
+    interaction_list.Sweep<Interaction::PhaseField>();
+    //    interaction_list.Sweep<Interaction::Curvature>();
 }
 //----------------------------------------------------------------------------------------
 //              summation for particles density and shear rates with updating interaction list
@@ -240,20 +219,12 @@ void Hydrodynamics::UpdateDensity(ParticleManager &particles, QuinticSpline &wei
 {       
 
     //obtain the interaction pairs
-    particles.BuildInteraction(interaction_list, particle_list, forces, weight_function, ini);
+    particles.BuildInteraction(interaction_list, forces, weight_function);
         
     //initiate zero density
     Zero_density();
-    //iterate the interaction list
-    for (LlistNode<Interaction> *p1 = interaction_list.first(); 
-         !interaction_list.isEnd(p1); 
-         p1 = interaction_list.next(p1)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p1);
-        //calculate the pair forces or change rate
-        pair->SummationDensity();       
-    }
+    //iterate the interaction list, the pair values are computed in the same sweep
+    interaction_list.Sweep<Interaction::Renew, Interaction::Density>();
                 
     //calulate new pressure
     UpdateState();
@@ -266,18 +237,23 @@ void Hydrodynamics::UpdateShearRate()
     //initiate zero shear rate
     Zero_ShearRate();
     //iterate the interaction list
-    for (LlistNode<Interaction> *p2 = interaction_list.first(); 
-         !interaction_list.isEnd(p2); 
-         p2 = interaction_list.next(p2)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p2);
-        //calculate the pair forces or change rate
-        pair->SummationShearRate();
-    }
+    interaction_list.Sweep<Interaction::ShearRate>();
 
 }
 //----------------------------------------------------------------------------------------
+//              renew the pair values and summation for particles density in one sweep
+//----------------------------------------------------------------------------------------
+void Hydrodynamics::UpdatePairDensity()
+{       
+    //initiate zero density
+    Zero_density();
+    //iterate the interaction list
+    interaction_list.Sweep<Interaction::Renew, Interaction::Density>();
+
+    //calulate new pressure
+    UpdateState();
+}
+//----------------------------------------------------------------------------------------
 //              summation for particles density and shear rates without updating interaction list
 //----------------------------------------------------------------------------------------
 void Hydrodynamics::UpdateDensity()
@@ -285,15 +261,7 @@ void Hydrodynamics::UpdateDensity()
     //initiate zero density
     Zero_density();
     //iterate the interaction list
-    for (LlistNode<Interaction> *p1 = interaction_list.first(); 
-         !interaction_list.isEnd(p1); 
-         p1 = interaction_list.next(p1)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p1);
-        //calculate the pair forces or change rate
-        pair->SummationDensity();       
-    }
+    interaction_list.Sweep<Interaction::Density>();
 
     //calulate new pressure
     UpdateState();
@@ -307,19 +275,12 @@ void Hydrodynamics::UpdateChangeRate(ParticleManager &particles, QuinticSpline &
     ZeroChangeRate();
 
     //obtain the interaction pairs
-    particles.BuildInteraction(interaction_list, particle_list, forces, weight_function, ini);
+    particles.BuildInteraction(interaction_list, forces, weight_function);
 
-    //iterate the interaction list
-    for (LlistNode<Interaction> *p = interaction_list.first(); 
-         !interaction_list.isEnd(p); 
-         p = interaction_list.next(p)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p);
-        //calculate the pair forces or change rate
-        pair->UpdateForces();
-
-    }
+    //iterate the interaction list, the pair values are computed in the same sweep
+    interaction_list.Sweep<Interaction::Renew, Interaction::Forces>();
+    //the polymer bonds, also with RESPA sub steps for the predictor and the output
+    bonds.BondForces();
 
     //include the gravity effects
     AddGravity();
@@ -332,43 +293,10 @@ void Hydrodynamics::UpdateChangeRate()
     //initiate the change rate of each real particle
     ZeroChangeRate();   
 
-#ifdef _OPENMP
-#pragma omp parallel
-    {
-        int current_thread = 0;
-        int thread_num = omp_get_num_threads();
-        int this_thread_num = omp_get_thread_num();
-#endif
-        //iterate the interaction list
-        for (LlistNode<Interaction> *p = interaction_list.first(); 
-             !interaction_list.isEnd(p); 
-             p = interaction_list.next(p)) {
-#ifdef _OPENMP
-            if (current_thread == this_thread_num)
-#endif
-                //a interaction pair
-                //calculate the pair forces or change rate
-                interaction_list.retrieve(p)->UpdateForces();
-#ifdef _OPENMP
-            current_thread++;
-            if (current_thread == thread_num)
-                current_thread = 0;
-#endif
-        }
-#ifdef _OPENMP
-    }
-
-    for (LlistNode<Interaction> *p = interaction_list.first(); 
-         !interaction_list.isEnd(p); 
-         p = interaction_list.next(p)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p);
-        //calculate the pair forces or change rate
-        pair->SummationUpdateForces();
-
-    }
-#endif
+    //iterate the interaction list
+    interaction_list.Sweep<Interaction::Forces>();
+    //the polymer bonds, also with RESPA sub steps for the predictor and the output
+    bonds.BondForces();
 
     //include the gravity effects
     AddGravity();
@@ -381,19 +309,14 @@ void Hydrodynamics::UpdateRandom(double sqrtdt)
     //initiate the change rate of each real particle
     Zero_Random();
 
-    //set a new random seed
-    //  wiener.Ranils();
+    //draw the Wiener increments of all pairs, keyed by the step and the pair
+    wiener.get_wiener(random_step, interaction_list.number_of_pairs, 
+                      interaction_list.Org, interaction_list.Dest, sqrtdt, 
+                      interaction_list.random_p, interaction_list.random_v);
+    random_step++;
 
     //iterate the interaction list
-    for (LlistNode<Interaction> *p = interaction_list.first(); 
-         !interaction_list.isEnd(p); 
-         p = interaction_list.next(p)) {
-                
-        //a interaction pair
-        Interaction *pair = interaction_list.retrieve(p);
-        //calculate the pair forces or change rate
-        pair->RandomForces(wiener, sqrtdt);             
-    }
+    interaction_list.Sweep<Interaction::Random>();
         
 }
 //----------------------------------------------------------------------------------------
@@ -402,18 +325,13 @@ void Hydrodynamics::UpdateRandom(double sqrtdt)
 void Hydrodynamics::ZeroChangeRate()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all densities and conservqtives
-        prtl->dedt = 0.0;
-        prtl->drhodt = 0.0;
-        (prtl->dUdt) = 0.0;
-        (prtl->_dU) = 0.0;
+        store.dedt[prtl] = 0.0;
+        store.drhodt[prtl] = 0.0;
+        store.dUdt[prtl] = 0.0;
+        store._dU[prtl] = 0.0;
 
     }
 }
@@ -423,15 +341,10 @@ void Hydrodynamics::ZeroChangeRate()
 void Hydrodynamics::Zero_density()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all densities and conservqtives
-        prtl->rho = 0.0;
+        store.rho[prtl] = 0.0;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -440,16 +353,11 @@ void Hydrodynamics::Zero_density()
 void Hydrodynamics::Zero_ShearRate()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all shear rate
-        (prtl->ShearRate_x) = 0.0;
-        (prtl->ShearRate_y) = 0.0;
+        store.ShearRate_x[prtl] = 0.0;
+        store.ShearRate_y[prtl] = 0.0;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -458,27 +366,17 @@ void Hydrodynamics::Zero_ShearRate()
 void Hydrodynamics::Zero_PhaseGradient(Boundary &boundary)
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all phase gradient
-        (prtl->del_phi) = 0.0;
+        store.del_phi[prtl] = 0.0;
     }
 
     //iterate particles on the boundary particle list
-    for (LlistNode<Particle> *p1 = boundary.boundary_particle_list.first(); 
-         !boundary.boundary_particle_list.isEnd(p1); 
-         p1 = boundary.boundary_particle_list.next(p1)) {
-                                        
-        //particle
-        Particle *prtl = boundary.boundary_particle_list.retrieve(p1);
+    for(int prtl = store.number_of_real; prtl < store.number_of_particles; prtl++) {
 
         //all phase gradient
-        (prtl->del_phi) = 0.0;
+        store.del_phi[prtl] = 0.0;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -489,29 +387,19 @@ void Hydrodynamics::Zero_PhaseLaplacian(Boundary &boundary)
     int i, j;
 
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all phase Laplacian
         for(i = 0; i < number_of_materials; i++)
-            for(j = 0; j < number_of_materials; j++) prtl->lap_phi[i][j] = 0.0;
+            for(j = 0; j < number_of_materials; j++) store.LapPhi(prtl)[i*number_of_materials + j] = 0.0;
     }
 
     //iterate particles on the boundary particle list
-    for (LlistNode<Particle> *p1 = boundary.boundary_particle_list.first(); 
-         !boundary.boundary_particle_list.isEnd(p1); 
-         p1 = boundary.boundary_particle_list.next(p1)) {
-                                        
-        //particle
-        Particle *prtl = boundary.boundary_particle_list.retrieve(p1);
+    for(int prtl = store.number_of_real; prtl < store.number_of_particles; prtl++) {
 
         //all phase Laplacian
         for(i = 0; i < number_of_materials; i++)
-            for(j = 0; j < number_of_materials; j++) prtl->lap_phi[i][j] = 0.0;
+            for(j = 0; j < number_of_materials; j++) store.LapPhi(prtl)[i*number_of_materials + j] = 0.0;
     }
 
 }
@@ -523,29 +411,19 @@ void Hydrodynamics::Zero_PhaseField(Boundary &boundary)
     int i, j;
 
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all phases
         for(i = 0; i < number_of_materials; i++)
-            for(j = 0; j < number_of_materials; j++) prtl->phi[i][j] = 0.0;
+            for(j = 0; j < number_of_materials; j++) store.Phi(prtl)[i*number_of_materials + j] = 0.0;
     }
 
     //iterate particles on the boundary particle list
-    for (LlistNode<Particle> *p1 = boundary.boundary_particle_list.first(); 
-         !boundary.boundary_particle_list.isEnd(p1); 
-         p1 = boundary.boundary_particle_list.next(p1)) {
-                                        
-        //particle
-        Particle *prtl = boundary.boundary_particle_list.retrieve(p1);
+    for(int prtl = store.number_of_real; prtl < store.number_of_particles; prtl++) {
 
         //all phases
         for(i = 0; i < number_of_materials; i++)
-            for(j = 0; j < number_of_materials; j++) prtl->phi[i][j] = 0.0;
+            for(j = 0; j < number_of_materials; j++) store.Phi(prtl)[i*number_of_materials + j] = 0.0;
     }
 
 }
@@ -555,15 +433,10 @@ void Hydrodynamics::Zero_PhaseField(Boundary &boundary)
 void Hydrodynamics::Zero_Velocity()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all random values
-        (prtl->U) = 0.0;
+        store.U[prtl] = 0.0;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -572,15 +445,10 @@ void Hydrodynamics::Zero_Velocity()
 void Hydrodynamics::Zero_Random()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all random values
-        (prtl->_dU) = 0.0;
+        store._dU[prtl] = 0.0;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -589,28 +457,24 @@ void Hydrodynamics::Zero_Random()
 void Hydrodynamics::AddGravity()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {    
-         //a particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 	const double Ly = ini.box_size[1];
-	const double y = prtl->R[1];
+	const double y = store.R[prtl][1];
 	const double ky = 2*pi/Ly;
 	const Vec2d kolForce (gravity[0]*cos(ky*y), 0.0);
 //	const Vec2d kolForcesmall(gravity[0]*cos(ky*y)*0.8, 0.0);
 //std::cerr<<"Time"<<Time;
 //if(Time<4)
 //{       
-prtl->dUdt = prtl->dUdt + kolForce;
+store.dUdt[prtl] = store.dUdt[prtl] + kolForce;
 //std::cerr<<kolForce<<std::endl;
  
 //}
 //else
 //{
-//prtl->dUdt = prtl->dUdt + kolForcesmall;
+//store.dUdt[prtl] = store.dUdt[prtl] + kolForcesmall;
 //std::cerr<<kolForcesmall;
-// }      // prtl->dUdt = prtl->dUdt + gravity
+// }      // store.dUdt[prtl] = store.dUdt[prtl] + gravity
     }
 }
 //----------------------------------------------------------------------------------------
@@ -619,16 +483,11 @@ prtl->dUdt = prtl->dUdt + kolForce;
 void Hydrodynamics::UpdateState()
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //a particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //states
-        prtl->p = prtl->mtl->get_p(prtl->rho);
-        //                      prtl->T = prtl->mtl->get_T(prtl->e);
+        store.p[prtl] = store.mtl[prtl]->get_p(store.rho[prtl]);
+        //                      store.T[prtl] = store.mtl[prtl]->get_T(store.e[prtl]);
     }
 
 }
@@ -638,32 +497,22 @@ void Hydrodynamics::UpdateState()
 void Hydrodynamics::UpdatePahseMatrix(Boundary &boundary)
 {
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //a particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all phase surface stress
         for(int i = 0; i < number_of_materials; i++)
             for(int j = 0; j < number_of_materials; j++) {
-                if( i != j) prtl->phi[i][j] = prtl->phi[i][j]; //prtl->phi[i][i]/(prtl->phi[i][i] + prtl->phi[j][j] + 1.0e-30);
+                if( i != j) store.Phi(prtl)[i*number_of_materials + j] = store.Phi(prtl)[i*number_of_materials + j]; //store.Phi(prtl)[i*number_of_materials + i]/(store.Phi(prtl)[i*number_of_materials + i] + store.Phi(prtl)[j*number_of_materials + j] + 1.0e-30);
             }
     }
 
     //iterate particles on the boundary particle list
-    for (LlistNode<Particle> *p1 = boundary.boundary_particle_list.first(); 
-         !boundary.boundary_particle_list.isEnd(p1); 
-         p1 = boundary.boundary_particle_list.next(p1)) {
-                                        
-        //particle
-        Particle *prtl = boundary.boundary_particle_list.retrieve(p1);
+    for(int prtl = store.number_of_real; prtl < store.number_of_particles; prtl++) {
 
         //all phase surface stress
         for(int i = 0; i < number_of_materials; i++)
             for(int j = 0; j < number_of_materials; j++) {
-                if( i != j) prtl->phi[i][j] = prtl->phi[i][j]; //prtl->phi[i][i]/(prtl->phi[i][i] + prtl->phi[j][j] + 1.0e-30);
+                if( i != j) store.Phi(prtl)[i*number_of_materials + j] = store.Phi(prtl)[i*number_of_materials + j]; //store.Phi(prtl)[i*number_of_materials + i]/(store.Phi(prtl)[i*number_of_materials + i] + store.Phi(prtl)[j*number_of_materials + j] + 1.0e-30);
             }
     }
 }
@@ -677,35 +526,25 @@ void Hydrodynamics::UpdateSurfaceStress(Boundary &boundary)
     double interm0, interm1, interm2;
 
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //a particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all phase surface stress
-        interm0 = 1.0/(v_abs(prtl->del_phi) + epsilon);
-        interm1 = 0.5*v_sqdiff(prtl->del_phi);
-        interm2 = product(prtl->del_phi);
-        prtl->del_phi[0] = interm1*interm0;
-        prtl->del_phi[1] = interm2*interm0;
+        interm0 = 1.0/(v_abs(store.del_phi[prtl]) + epsilon);
+        interm1 = 0.5*v_sqdiff(store.del_phi[prtl]);
+        interm2 = product(store.del_phi[prtl]);
+        store.del_phi[prtl][0] = interm1*interm0;
+        store.del_phi[prtl][1] = interm2*interm0;
     }
 
     //iterate particles on the boundary particle list
-    for (LlistNode<Particle> *p1 = boundary.boundary_particle_list.first(); 
-         !boundary.boundary_particle_list.isEnd(p1); 
-         p1 = boundary.boundary_particle_list.next(p1)) {
-                                        
-        //particle
-        Particle *prtl = boundary.boundary_particle_list.retrieve(p1);
+    for(int prtl = store.number_of_real; prtl < store.number_of_particles; prtl++) {
 
         //all phase surface stress
-        interm0 = v_abs(prtl->del_phi) + epsilon;
-        interm1 = 0.5*v_sqdiff(prtl->del_phi);
-        interm2 = product(prtl->del_phi);
-        prtl->del_phi[0] = interm1/interm0;
-        prtl->del_phi[1] = interm2/interm0;
+        interm0 = v_abs(store.del_phi[prtl]) + epsilon;
+        interm1 = 0.5*v_sqdiff(store.del_phi[prtl]);
+        interm2 = product(store.del_phi[prtl]);
+        store.del_phi[prtl][0] = interm1/interm0;
+        store.del_phi[prtl][1] = interm2/interm0;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -717,56 +556,52 @@ double Hydrodynamics::SurfaceTensionCoefficient()
     double coefficient = 0.0; double totalvolume = 0.0;
 
     //iterate particles on the real particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //a particle
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
 
         //all phase surface stress
-        double interm1 = prtl->m/prtl->rho;
+        double interm1 = store.m[prtl]/store.rho[prtl];
         totalvolume += interm1;
-        coefficient += v_sq(prtl->del_phi)*interm1;
+        coefficient += v_sq(store.del_phi[prtl])*interm1;
     }
     return coefficient/sqrt(totalvolume);
 }
 //----------------------------------------------------------------------------------------
+//                      sums up the kernel weights of the neighbours of each particle
+//----------------------------------------------------------------------------------------
+struct WeightSum {
+    QuinticSpline &weight_function;
+    double *sum;
+    WeightSum(QuinticSpline &weight_function, double *sum): weight_function(weight_function), sum(sum) {}
+    void operator()(int prtl_org, int prtl_dest, double r, double r2) { sum[prtl_org] += weight_function.w(r); }
+};
+//----------------------------------------------------------------------------------------
+//                              xy virial of the pair and the bond forces
+//----------------------------------------------------------------------------------------
+double Hydrodynamics::ShearVirial() const
+{
+    return interaction_list.ShearVirial() + bonds.ShearVirial();
+}
+//----------------------------------------------------------------------------------------
+//                              number of pairs in the interaction list
+//----------------------------------------------------------------------------------------
+int Hydrodynamics::NumberOfPairs() const
+{
+    return interaction_list.number_of_pairs;
+}
+//----------------------------------------------------------------------------------------
 //                                                              calculate partilce volume
 //----------------------------------------------------------------------------------------
 void Hydrodynamics::UpdateVolume(ParticleManager &particles, QuinticSpline &weight_function)
 {
-    double reciprocV; //the inverse of volume or volume
-
-    //iterate particles on the particle list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                        
-        //origin particle
-        Particle *prtl_org = particle_list.retrieve(p);
-        //build the nearest particle list
-        particles.BuildNNP(prtl_org->R);
-
-        reciprocV = 0.0; 
-        //iterate this Nearest Neighbor Particle list
-        for (LlistNode<Particle> *p1 = particles.NNP_list.first(); 
-             !particles.NNP_list.isEnd(p1); 
-             p1 = particles.NNP_list.next(p1)) {
-                        
-            //get a particle
-            Particle *prtl_dest = particles.NNP_list.retrieve(p1);
-                                
-            //summation the weights
-            reciprocV += weight_function.w(v_distance(prtl_org->R, prtl_dest->R));
-        }
-        //calculate volume
-        prtl_org->V = 1.0/reciprocV;
-                
-        //clear the NNP_list
-        particles.NNP_list.clear();
-    }
+    int prtl;
+
+    //summation the weights of the neighbours, the particles in parallel
+    for(prtl = 0; prtl < store.number_of_real; prtl++) store.V[prtl] = 0.0;
+    WeightSum sum(weight_function, store.V);
+    particles.ForNeighbours(store.number_of_real, store.R, sum);
 
+    //calculate volume
+    for(prtl = 0; prtl < store.number_of_real; prtl++) store.V[prtl] = 1.0/store.V[prtl];
 }
 //----------------------------------------------------------------------------------------
 //                                                      get the time step
@@ -779,15 +614,11 @@ double Hydrodynamics::GetTimestep()
 
     //predict the time step
     //iterate the partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                                
-        Particle *prtl = particle_list.retrieve(p);
-        Cs_max = AMAX1(Cs_max, prtl->Cs);
-        V_max = AMAX1(V_max, v_abs(prtl->U));
-        rho_min = AMIN1(rho_min, prtl->rho);
-        rho_max = AMAX1(rho_max, prtl->rho);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
+        Cs_max = AMAX1(Cs_max, store.Cs[prtl]);
+        V_max = AMAX1(V_max, v_abs(store.U[prtl]));
+        rho_min = AMIN1(rho_min, store.rho[prtl]);
+        rho_max = AMAX1(rho_max, store.rho[prtl]);
     }
 
     dt = AMIN1(sqrt(0.5*(rho_min + rho_max))*dt_surf, dt_g_vis) ;
@@ -799,26 +630,22 @@ double Hydrodynamics::GetTimestep()
 void Hydrodynamics::Predictor(double dt)
 {
     //iterate the real partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
         
         //save values at step n
-        prtl->R_I = prtl->R;
-        prtl->rho_I = prtl->rho;
-        prtl->U_I = prtl->U;
+        store.R_I[prtl] = store.R[prtl];
+        store.rho_I[prtl] = store.rho[prtl];
+        store.U_I[prtl] = store.U[prtl];
                         
         //predict values at step n+1
-        prtl->R = prtl->R + prtl->U*dt;
-        prtl->rho = prtl->rho + prtl->drhodt*dt;
-        prtl->U = prtl->U + prtl->dUdt*dt;
+        store.R[prtl] = store.R[prtl] + store.U[prtl]*dt;
+        store.rho[prtl] = store.rho[prtl] + store.drhodt[prtl]*dt;
+        store.U[prtl] = store.U[prtl] + store.dUdt[prtl]*dt;
                         
         //calculate the middle values at step n+1/2
-        prtl->R = (prtl->R + prtl->R_I)*0.5;
-        prtl->rho = (prtl->rho + prtl->rho_I)*0.5;
-        prtl->U = (prtl->U + prtl->U_I)*0.5;
+        store.R[prtl] = (store.R[prtl] + store.R_I[prtl])*0.5;
+        store.rho[prtl] = (store.rho[prtl] + store.rho_I[prtl])*0.5;
+        store.U[prtl] = (store.U[prtl] + store.U_I[prtl])*0.5;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -827,16 +654,12 @@ void Hydrodynamics::Predictor(double dt)
 void Hydrodynamics::Corrector(double dt)
 {
     //iterate the real partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-        
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
                         
         //correction base on values on n step and change rate at n+1/2
-        prtl->R = prtl->R_I + prtl->U*dt;
-        prtl->rho = prtl->rho + prtl->drhodt*dt;
-        prtl->U = prtl->U_I + prtl->dUdt*dt;
+        store.R[prtl] = store.R_I[prtl] + store.U[prtl]*dt;
+        store.rho[prtl] = store.rho[prtl] + store.drhodt[prtl]*dt;
+        store.U[prtl] = store.U_I[prtl] + store.dUdt[prtl]*dt;
     }
 }
 //----------------------------------------------------------------------------------------
@@ -845,23 +668,19 @@ void Hydrodynamics::Corrector(double dt)
 void Hydrodynamics::Predictor_summation(double dt)
 {
     //iterate the real partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-                
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
                                 
 			//save values at step n
-			prtl->R_I = prtl->R;
-			prtl->U += prtl->_dU; //renormalize velocity
-			prtl->U_I = prtl->U;
+			store.R_I[prtl] = store.R[prtl];
+			store.U[prtl] += store._dU[prtl]; //renormalize velocity
+			store.U_I[prtl] = store.U[prtl];
 			//predict values at step n+1
-			prtl->R = prtl->R + prtl->U*dt;
-			prtl->U = prtl->U + prtl->dUdt*dt;
+			store.R[prtl] = store.R[prtl] + store.U[prtl]*dt;
+			store.U[prtl] = store.U[prtl] + store.dUdt[prtl]*dt;
                         
 			//calculate the middle values at step n+1/2
-			prtl->R = (prtl->R + prtl->R_I)*0.5;
-			prtl->U = (prtl->U + prtl->U_I)*0.5;
+			store.R[prtl] = (store.R[prtl] + store.R_I[prtl])*0.5;
+			store.U[prtl] = (store.U[prtl] + store.U_I[prtl])*0.5;
 		
     }
 }
@@ -872,33 +691,94 @@ void Hydrodynamics::Predictor_summation(double dt)
 void Hydrodynamics::Corrector_summation(double dt)
 {
     //iterate the real partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-        
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
                         
         //correction base on values on n step and change rate at n+1/2
 		
-			prtl->U += prtl->_dU; //renormalize velocity
-			prtl->R = prtl->R_I + prtl->U*dt;
-			prtl->U = prtl->U_I + prtl->dUdt*dt;
+			store.U[prtl] += store._dU[prtl]; //renormalize velocity
+			store.R[prtl] = store.R_I[prtl] + store.U[prtl]*dt;
+			store.U[prtl] = store.U_I[prtl] + store.dUdt[prtl]*dt;
 		}   
 }
 //----------------------------------------------------------------------------------------
+//                      the predictor and corrector method: corrector with multiple time steps
+//                      the FENE bonds are integrated with velocity Verlet in sub steps,
+//                      the other change rates at n+1/2 are kept constant over the time step;
+//                      the predictor takes the bond forces at step n with the other forces
+//----------------------------------------------------------------------------------------
+void Hydrodynamics::Corrector_respa(double dt)
+{
+    int prtl, n;
+    const double sub_dt = dt/respa_steps, half_dt = 0.5*sub_dt;
+
+    if(store.number_of_real > bond_dUdt_length) {
+        delete[] bond_dUdt;
+        bond_dUdt_length = store.number_of_real;
+        bond_dUdt = new Vec2d[bond_dUdt_length];
+    }
+
+    //the pair change rates at n+1/2 without the bond forces added by UpdateChangeRate()
+    for(prtl = 0; prtl < store.number_of_real; prtl++) bond_dUdt[prtl] = 0.0;
+    bonds.BondForces(bond_dUdt);
+    for(prtl = 0; prtl < store.number_of_real; prtl++) store.dUdt[prtl] = store.dUdt[prtl] - bond_dUdt[prtl];
+
+    //start from the values at step n
+    for(prtl = 0; prtl < store.number_of_real; prtl++) {
+        store.R[prtl] = store.R_I[prtl];
+        store.U[prtl] = store.U_I[prtl];
+        bond_dUdt[prtl] = 0.0;
+    }
+    bonds.BondForces(bond_dUdt);
+
+    for(n = 0; n < respa_steps; n++) {
+        for(prtl = 0; prtl < store.number_of_real; prtl++) {
+            store.U[prtl] = store.U[prtl] + (store.dUdt[prtl] + bond_dUdt[prtl])*half_dt;
+            store.R[prtl] = store.R[prtl] + store.U[prtl]*sub_dt;
+            bond_dUdt[prtl] = 0.0;
+        }
+        bonds.BondForces(bond_dUdt);
+        for(prtl = 0; prtl < store.number_of_real; prtl++) 
+            store.U[prtl] = store.U[prtl] + (store.dUdt[prtl] + bond_dUdt[prtl])*half_dt;
+    }
+
+    //the change rates include the bond forces at n+1 again
+    for(prtl = 0; prtl < store.number_of_real; prtl++) store.dUdt[prtl] = store.dUdt[prtl] + bond_dUdt[prtl];
+}
+//----------------------------------------------------------------------------------------
+//                      velocity Verlet (Groot-Warren, lambda = 1/2): first half step
+//                      the velocity at n+1/2 is kept in U_I
+//----------------------------------------------------------------------------------------
+void Hydrodynamics::VerletDrift(double dt)
+{
+    //iterate the real partilce list
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
+        store.U_I[prtl] = store.U[prtl] + store.dUdt[prtl]*(0.5*dt);
+        store.R[prtl] = store.R[prtl] + store.U_I[prtl]*dt;
+        //estimated velocity at n+1 for the viscous forces
+        store.U[prtl] = store.U_I[prtl] + store.dUdt[prtl]*(0.5*dt);
+    }
+}
+//----------------------------------------------------------------------------------------
+//                      velocity Verlet: second half step of the velocity
+//                      with the velocity correction of the artificial viscosity in _dU,
+//                      before UpdateRandom() replaces it with the random increments
+//----------------------------------------------------------------------------------------
+void Hydrodynamics::VerletKick(double dt)
+{
+    //iterate the real partilce list
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) 
+        store.U[prtl] = store.U_I[prtl] + store.dUdt[prtl]*(0.5*dt) + store._dU[prtl];
+}
+//----------------------------------------------------------------------------------------
 //                                                      including random effects
 //----------------------------------------------------------------------------------------
 void Hydrodynamics::RandomEffects()
 {
     //iterate the real partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-        
-        Particle *prtl = particle_list.retrieve(p);
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
                         
         //correction base on values on n step and change rate at n+1/2
-					prtl->U = prtl->U + prtl->_dU;
+					store.U[prtl] = store.U[prtl] + store._dU[prtl];
 	  
 }
 
@@ -914,14 +794,10 @@ void Hydrodynamics::MovingTest(Initiation &ini)
     double f_rdmx = (float)RAND_MAX;
         
     //iterate the partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-        
-        Particle *prtl = particle_list.retrieve(p);
-        if(prtl->bd == 0) {
-            prtl->U_I = prtl->U;
-            prtl->U =  prtl->U + prtl->U*0.1*((float)rand() - f_rdmx / 2.0) / f_rdmx;
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
+        if(store.bd[prtl] == 0) {
+            store.U_I[prtl] = store.U[prtl];
+            store.U[prtl] =  store.U[prtl] + store.U[prtl]*0.1*((float)rand() - f_rdmx / 2.0) / f_rdmx;
         }
     }
 }
@@ -934,13 +810,10 @@ double Hydrodynamics::ConservationTest()
     Vec2d sU = 0.0;
     Vec2d U = 0.0; 
     //iterate the partilce list
-    for (LlistNode<Particle> *p = particle_list.first(); 
-         !particle_list.isEnd(p); 
-         p = particle_list.next(p)) {
-        const Particle *prtl = particle_list.retrieve(p);
-        sU = sU + prtl->dUdt;
-        sdU = sdU + prtl->_dU;
-        U = U + prtl->U;
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) {
+        sU = sU + store.dUdt[prtl];
+        sdU = sdU + store._dU[prtl];
+        U = U + store.U[prtl];
     }
 
     return v_abs(U);
@@ -953,4 +826,5 @@ void Hydrodynamics::setTime(const double newTime) {
 Hydrodynamics::~Hydrodynamics() {
   delete [] materials;
   delete [] forces;
+  delete [] bond_dUdt;
 }
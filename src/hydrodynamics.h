@@ -11,7 +11,6 @@ class ParticleManager;
 class QuinticSpline;
 class Boundary;
 class Initiation;
-class Particle;
 
 /// Definition of hydrodynamics
 class Hydrodynamics
@@ -26,7 +25,15 @@ class Hydrodynamics
     double Time;
 
     ///the interaction (particle pair) list
-    Llist<Interaction> interaction_list;
+    Interaction interaction_list;
+    ///the FENE bonds between the polymer beads
+    BondList bonds;
+
+    ///sub steps of the FENE bonds in one time step, 1: the bonds are summed up with the pair forces
+    int respa_steps;
+    ///acceleration by the bonds in the sub steps
+    Vec2d *bond_dUdt;
+    int bond_dUdt_length; ///length of the bond_dUdt array
 
     ///for time step 
     double viscosity_max, surface_max;
@@ -38,10 +45,13 @@ public:
     Material *materials;
     ///the interaction force used
     Force **forces;
-    Llist<Particle> particle_list; ///particle list for all particles
+    ///all particles, owned by the particle manager
+    ParticleStore &store;
 
     ///Wiener process
     Wiener wiener;
+    ///number of random force evaluations, counter of the Wiener increments
+    long random_step;
 
     ///constructor
     Hydrodynamics(ParticleManager &particles, Initiation &ini);
@@ -52,9 +62,12 @@ public:
     ///get the time step
     double GetTimestep();
 
+    ///find the FENE bonds between the polymer beads, after the boundary conditions are known
+    void BuildBonds(Boundary &boundary);
+
     ///update new parameters in pairs
     void BuildPair(ParticleManager &particles, QuinticSpline &weight_function);
-    void UpdatePair(QuinticSpline &weight_function);
+    void UpdatePair();
 
     ///manupilate the particle physics
     ///initiate particle change rate
@@ -74,6 +87,8 @@ public:
     ///currently no shear rate calculated  without updating interaction list
     void UpdateDensity();
     void UpdateShearRate();
+    ///renew the pair values and summation for particles density in one sweep
+    void UpdatePairDensity();
         
     ///update pahse field
     void UpdatePhaseGradient(Boundary &boundary);
@@ -90,6 +105,10 @@ public:
     void UpdateState();
     ///calculate partilce volume
     void UpdateVolume(ParticleManager &particles, QuinticSpline &weight_function);
+    ///xy virial of the pair and the bond forces, without the random forces
+    double ShearVirial() const;
+    ///number of pairs in the interaction list
+    int NumberOfPairs() const;
 
     ///for predictor and corrector method, density evaluated directly
     void Predictor(double dt);
@@ -98,6 +117,17 @@ public:
     ///for predictor and corrector method, density evaluated with summation
     void Predictor_summation(double dt);
     void Corrector_summation(double dt);
+    ///corrector with the FENE bonds in respa_steps sub steps (RESPA),
+    ///the other forces are kept at their values at n+1/2;
+    ///dUdt holds the bond forces at n+1/2 on entry and at n+1 on return
+    void Corrector_respa(double dt);
+
+    ///for velocity Verlet, density evaluated with summation
+    ///half step of the velocity, full step of the positions and the velocity estimate for the forces
+    void VerletDrift(double dt);
+    ///second half step of the velocity with the change rates at the new positions
+    ///and the velocity correction of the artificial viscosity
+    void VerletKick(double dt);
 
     ///DPD simultion
     ///initiate random force
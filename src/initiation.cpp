@@ -18,7 +18,8 @@
 #include "glbcls.h"
 #include "glbfunc.h"
 #include "initiation.h"
-#include "particle.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
 #include "particlemanager.h"
 #include "quinticspline.h"
@@ -48,6 +49,35 @@ Initiation::Initiation(const char *project_name) {
     }
     else cout<<"Initialtion: Read the global configuration data from "<< inputfile <<" \n"; 
 
+    //no Verlet pair list by default
+    verlet_skin = 0.0;
+    //serial summation of the pair contributions by default
+    pair_scatter = 0;
+    //analytic kernel by default
+    kernel_table_size = 0; kernel_table_order = 3;
+    //periodic ghost particles by default
+    periodic_wrap = 0;
+    //no FENE bonds by default
+    polymer_H = 0.0; polymer_r0 = 0.0;
+    //random seed from the clock by default
+    random_seed = 0;
+    //the FENE bonds advance with the time step by default
+    respa_steps = 1;
+    //predictor-corrector with density summation by default
+    integrator = 0;
+    //text restart file by default
+    restart_format = 0;
+    //the particle output is written in the background by default
+    async_output = 1;
+    //text movie by default, the binary movie is compressed by default
+    movie_format = 0; movie_compression = 1;
+    //the diagnose averages are sampled by MLS every time step by default
+    average_method = 0; average_stride = 1;
+    //the particle 1 is the tracer of the diagnose by default
+    number_of_tracers = 0; tracer_ID = NULL;
+    //no time correlations by default
+    correlation_interval = 0.0;
+
     //reading key words and configuration data
     while(!fin.eof()) {
                 
@@ -74,11 +104,60 @@ Initiation::Initiation(const char *project_name) {
         //comparing the key words for the ratio between cell size and initial particle width
         if(!strcmp(Key_word, "CELL_RATIO")) fin>>hdelta;
 
+        //comparing the key words for the skin distance of the Verlet pair list
+        if(!strcmp(Key_word, "VERLET_SKIN")) fin>>verlet_skin;
+
+        //comparing the key words for the summation of the pair contributions
+        if(!strcmp(Key_word, "PAIR_SCATTER")) fin>>pair_scatter;
+
+        //comparing the key words for the tabulated kernel
+        if(!strcmp(Key_word, "KERNEL_TABLE")) fin>>kernel_table_size>>kernel_table_order;
+
+        //comparing the key words for the periodic boundaries
+        if(!strcmp(Key_word, "PERIODIC_WRAP")) fin>>periodic_wrap;
+
+        //comparing the key words for the random seed
+        if(!strcmp(Key_word, "RANDOM_SEED")) fin>>random_seed;
+
         //comparing the key words for the g force
         if(!strcmp(Key_word, "G_FORCE")) fin>>g_force[0]>>g_force[1];
 
 		//read parameter of the FENE force
         if(!strcmp(Key_word, "FENE")) fin>> polymer_H >> polymer_r0;
+
+        //sub steps of the FENE bonds in one time step
+        if(!strcmp(Key_word, "RESPA")) fin>>respa_steps;
+
+        //the time integrator
+        if(!strcmp(Key_word, "INTEGRATOR")) fin>>integrator;
+
+        //the format of the restart file
+        if(!strcmp(Key_word, "RESTART_FORMAT")) fin>>restart_format;
+
+        //writing the particle output in the background
+        if(!strcmp(Key_word, "ASYNC_OUTPUT")) fin>>async_output;
+
+        //comparing the key words for the particle movie
+        if(!strcmp(Key_word, "MOVIE_FORMAT")) fin>>movie_format>>movie_compression;
+
+        //comparing the key words for the sampling of the diagnose averages
+        if(!strcmp(Key_word, "AVERAGE")) fin>>average_method>>average_stride;
+
+        //comparing the key words for the time correlations
+        if(!strcmp(Key_word, "CORRELATION")) fin>>correlation_interval;
+
+        //comparing the key words for the tracer particles of the diagnose
+        if(!strcmp(Key_word, "TRACERS")) {
+            fin>>number_of_tracers;
+            if(number_of_tracers < 1) {
+                cout<<"Initiation: the number of tracers must be at least 1! \n";
+                std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+                exit(1);
+            }
+            delete[] tracer_ID;
+            tracer_ID = new long[number_of_tracers];
+            for(int k = 0; k < number_of_tracers; k++) fin>>tracer_ID[k];
+        }
  
         //comparing the key words for the artificial viscosity
         if(!strcmp(Key_word, "ARTIFICIAL_VISCOSITY")) fin>>art_vis;
@@ -119,6 +198,43 @@ Initiation::Initiation(const char *project_name) {
       exit(EXIT_FAILURE);
     }
         
+    if(integrator < 0 || integrator > 2) {
+        cout<<"Initiation: the integrator must be 0, 1 or 2! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    //the FENE bonds are only sub-stepped by the predictor-corrector with density summation
+    if(respa_steps > 1 && integrator != 0) {
+        cout<<"Initiation: RESPA sub steps need the integrator 0! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(restart_format < 0 || restart_format > 1) {
+        cout<<"Initiation: the restart format must be 0 or 1! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(movie_format < 0 || movie_format > 1 || movie_compression < 0 || movie_compression > 1) {
+        cout<<"Initiation: the movie format and the movie compression must be 0 or 1! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(average_method < 0 || average_method > 2 || average_stride < 1) {
+        cout<<"Initiation: the average method must be 0, 1 or 2 and the average stride at least 1! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(correlation_interval < 0.0) {
+        cout<<"Initiation: the correlation interval must not be negative! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(respa_steps < 1) {
+        cout<<"Initiation: the number of RESPA sub steps must be at least 1! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+        
     //process the data
     box_size[0] = x_cells*cell_size; box_size[1] = y_cells*cell_size;
     delta = cell_size/hdelta;
@@ -136,11 +252,30 @@ void Initiation::show_information()
     cout<<"The computational domain size is  "<<box_size[0]<<" micrometers x "<<box_size[1]<<" micrometers\n";
     cout<<"The cell size is "<<cell_size<<" micrometers \n";
     cout<<"The smoothing length is "<<smoothinglength<<" micrometers \n";
+    if(verlet_skin > 0.0) cout<<"The skin distance of the Verlet pair list is "<<verlet_skin<<" micrometers \n";
+    if(pair_scatter == 1) cout<<"The pair contributions are summed up in parallel batches \n";
+    if(periodic_wrap == 1) cout<<"The periodic boundaries wrap the pair search around, without ghost particles \n";
+    if(random_seed != 0) cout<<"The random seed is "<<random_seed<<", the results are reproducible \n";
+    if(kernel_table_size > 0) cout<<"The kernel is tabulated with "<<kernel_table_size<<" intervals in the squared distance \n";
     cout<<"The cell matrix size is "<<x_cells<<" x "<<y_cells<<"\n";
     cout<<"The ratio between cell size and initial particle width is "<<hdelta<<"\n";
     cout<<"The initial particle width is "<<delta<<" micrometers\n";
     cout<<"The g force is "<<g_force[0]<<" m/s^2 x "<<g_force[1]<<" m/s^2 \n";
 	cout<<"FENE paramters (H, R) are "<< polymer_H << "  "<< polymer_r0 << '\n';
+    if(integrator == 1) cout<<"The time integrator is predictor-corrector with the continuity equation \n";
+    if(integrator == 2) cout<<"The time integrator is velocity Verlet with density summation \n";
+    if(respa_steps > 1) cout<<"The FENE bonds are integrated in "<<respa_steps<<" sub steps of each time step \n";
+    if(restart_format == 1) cout<<"The restart file is written in binary \n";
+    if(movie_format == 1) cout<<"The particle movie is written in binary \n";
+    if(async_output == 0) cout<<"The particle output is written by the computation, not in the background \n";
+    if(correlation_interval > 0.0) 
+        cout<<"The sampling interval of the velocity and stress autocorrelations is "<<correlation_interval<<" \n";
+    if(diagnose == 1) {
+        if(average_method == 1) cout<<"The averages are sampled by binning the particles to the nearest grid points \n";
+        if(average_method == 2) cout<<"The averages are sampled by depositing the particle states with the kernel \n";
+        if(average_stride > 1) cout<<"The averages are sampled every "<<average_stride<<" time steps \n";
+        if(number_of_tracers > 0) cout<<"The number of tracer particles is "<<number_of_tracers<<"\n";
+    }
 
     cout<<"The dimensionless reference length, speed, density and temperature are \n"
         <<_length<<" micrometer, "<<_v<<" m/s, "<<_rho<<" kg/m^3, "<<_T<<" K\n";
@@ -172,45 +307,12 @@ void Initiation::show_information()
 //----------------------------------------------------------------------------------------
 void Initiation::VolumeMass(Hydrodynamics &hydro, ParticleManager &particles, QuinticSpline &weight_function)
 {
+    ParticleStore &store = hydro.store;
 
-    double reciprocV; //the inverse of volume or volume
-    double dstc;
-    Vec2d eij, sumdw;
-
-    //iterate particles on the particle list
-    for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-         !hydro.particle_list.isEnd(p); 
-         p = hydro.particle_list.next(p)) {
-                                        
-        //origin particle
-        Particle *prtl_org = hydro.particle_list.retrieve(p);
-        //build the nearest particle list
-        particles.BuildNNP(prtl_org->R);
-
-        reciprocV = 0.0; sumdw = 0.0;
-        //iterate this Nearest Neighbor Particle list
-        for (LlistNode<Particle> *p1 = particles.NNP_list.first(); 
-             !particles.NNP_list.isEnd(p1); 
-             p1 = particles.NNP_list.next(p1)) {
-                        
-            //get a particle
-            Particle *prtl_dest = particles.NNP_list.retrieve(p1);
-                                
-            //summation the weights
-            dstc = v_distance(prtl_org->R, prtl_dest->R);
-            eij = (prtl_org->R - prtl_dest->R)/(dstc + 1.e-30);
-                                
-            reciprocV += weight_function.w(dstc);
-            sumdw = sumdw + eij*weight_function.F(dstc);
-        }
-        //calculate volume
-        reciprocV = 1.0/reciprocV;
-
-        //predict particle volume and mass
-        prtl_org->V = reciprocV;
-        prtl_org->m = prtl_org->rho*reciprocV;
-                        
-        //clear the NNP_list
-        particles.NNP_list.clear();
-    }
+    //the volume from the summation of the weights
+    hydro.UpdateVolume(particles, weight_function);
+
+    //predict particle mass
+    for(int prtl = 0; prtl < store.number_of_real; prtl++) 
+        store.m[prtl] = store.rho[prtl]*store.V[prtl];
 }
@@ -48,12 +48,45 @@ public:
     int hdelta;
     ///cells matrix for real particles
     int x_cells, y_cells;
+    ///skin distance of the Verlet pair list, 0: search the pairs at every time step
+    double verlet_skin;
+    ///how pair contributions are summed up to the particles
+    ///0: one serial pass, 1: in parallel batches of pairs sharing no particle
+    int pair_scatter;
+    ///number of intervals of the kernel table, 0: the kernel is evaluated directly
+    ///and the interpolation in the table, 1: linear, 3: cubic
+    int kernel_table_size, kernel_table_order;
+    ///periodic boundaries, 0: by ghost particles, 1: by the nearest image of the particles
+    int periodic_wrap;
+    ///seed of the random numbers, 0: taken from the clock
+    ///with a given seed the results do not depend on the number of threads
+    long random_seed;
     ///g force on particles
     Vec2d g_force;
 
 	/// FENE force paramters for the polymers F = H*r / (1 - (r/r0)^2)
 	double polymer_H;
 	double polymer_r0;
+	///number of sub steps of the FENE bonds in one time step, 1: no sub steps
+	int respa_steps;
+	///time integrator, 0: predictor-corrector with density summation,
+	///1: predictor-corrector with the continuity equation, 2: velocity Verlet with density summation
+	int integrator;
+	///restart file written by the output, 0: text, 1: binary
+	int restart_format;
+	///1: the particle output is written by a background thread, 0: by the computation
+	int async_output;
+	///particle movie, 0: text, 1: binary, and the compression of the binary movie,
+	///0: none, 1: differences to the frame before
+	int movie_format, movie_compression;
+	///sampling of the diagnose averages, 0: MLS mapping, 1: binning to the nearest
+	///grid point, 2: kernel deposition, and the number of time steps between samples
+	int average_method, average_stride;
+	///number and IDs of the tracer particles of the diagnose, 0: the particle 1
+	int number_of_tracers;
+	long *tracer_ID;
+	///time between the samples of the velocity and stress autocorrelations, 0: none
+	double correlation_interval;
 
 	/// IDs of moving particles
 	///int moveID1, moveID2,moveID3,moveID4;
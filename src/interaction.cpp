@@ -18,8 +18,8 @@
 #include "glbcls.h"
 #include "glbfunc.h"
 #include "interaction.h"
-#include "particle.h"
 #include "quinticspline.h"
+#include "kerneltable.h"
 #include "force.h"
 #include "initiation.h"
 #include "material.h"
@@ -30,109 +30,196 @@ int Interaction::number_of_materials = 0;
 double Interaction::smoothinglength = 0.0;
 double Interaction::art_vis = 0.0;
 double Interaction::delta = 0.0;
+
+//----------------------------------------------------------------------------------------
+//                      grow an array and keep its first old_length elements
+//----------------------------------------------------------------------------------------
+template <class T> static void GrowArray(T *&a, int old_length, int new_length)
+{
+    T *b = new T[new_length];
+    for(int n = 0; n < old_length; n++) b[n] = a[n];
+    delete[] a;
+    a = b;
+}
 //----------------------------------------------------------------------------------------
 //                                      constructor
 //----------------------------------------------------------------------------------------
-Interaction::Interaction(Initiation &ini):
-ini(ini)
+Interaction::Interaction(ParticleStore &particles, Initiation &ini):
+ini(ini), store(&particles), frc_ij(0), weight_function(0), kernel_table(0), 
+capacity(0), number_of_pairs(0)
 {
     //copy properties from initiation
     number_of_materials = ini.number_of_materials;
     smoothinglength = ini.smoothinglength;
     art_vis = ini.art_vis;
     delta = ini.delta;
+
+    Org = 0; Dest = 0;
+    rij = 0; Wij = 0; Fij = 0; LapWij = 0; eij = 0;
+    shear_rij = 0; bulk_rij = 0; random_p = 0; random_v = 0;
+    number_of_colours = 0;
+#ifdef _OPENMP
+    drhodt1 = 0; drhodt2 = 0; _dU1 = 0; _dU2 = 0; dUdt1 = 0; dUdt2 = 0;
+#endif
+    Reserve(4096);
 }
 //----------------------------------------------------------------------------------------
-//                                      constructor
+//                                      destructor
 //----------------------------------------------------------------------------------------
-Interaction::Interaction(Particle *prtl_org, Particle *prtl_dest, Force **forces,
-						 QuinticSpline &weight_function, double dstc, Initiation& ini):
-ini(ini)
+Interaction::~Interaction()
 {
-    //the original and the destinate particle in the reaction pair
-    Org = prtl_org;
-    Dest = prtl_dest;
-        
-    //interaction parameters
-    noi = Org->mtl->number;
-    noj = Dest->mtl->number; 
-    frc_ij = forces;
-
-    //define pair values do not change in sub time steps
-    mi = Org->m; mj = Dest->m;
-    rmi = 1.0/mi; rmj =1.0/mj;
-    etai = Org->eta; etaj = Dest->eta; 
-    zetai = Org->zeta; zetaj = Dest->zeta; 
-
-    //the pair parameters
-    rij = dstc;
-    rrij = 1.0/(rij + 1.0e-30);
-    eij = (Org->R - Dest->R)*rrij;
-    Wij = weight_function.w(rij);
-//      Fij = weight_function.F(rij); //for BetaSpline wight fuction
-    Fij = weight_function.F(rij)*rrij; //for QuinticSpline wight fuction
-    LapWij = weight_function.LapW(rij); //for QuinticSpline fuction
-    shear_rij = 2.0*etai*etaj*rij/(etai*(rij + 2.0*frc_ij[noj][noi].shear_slip) 
-                                   + etaj*(rij + 2.0*frc_ij[noi][noj].shear_slip) + 1.0e-30);
-    bulk_rij =  2.0*zetai*zetaj*rij/(zetai*(rij + 2.0*frc_ij[noj][noi].bulk_slip) 
-                                     + zetaj*(rij + 2.0*frc_ij[noi][noj].bulk_slip) + 1.0e-30);
+    delete[] Org; delete[] Dest;
+    delete[] rij; delete[] Wij; delete[] Fij; delete[] LapWij; delete[] eij;
+    delete[] shear_rij; delete[] bulk_rij; delete[] random_p; delete[] random_v;
+    delete kernel_table;
+#ifdef _OPENMP
+    delete[] drhodt1; delete[] drhodt2; delete[] _dU1; delete[] _dU2; delete[] dUdt1; delete[] dUdt2;
+#endif
 }
+//----------------------------------------------------------------------------------------
+//                              grow all arrays to hold at least n pairs
+//----------------------------------------------------------------------------------------
+void Interaction::Reserve(int n)
+{
+    if(n <= capacity) return;
+
+    int new_capacity = capacity > 0 ? capacity : 4096;
+    while(new_capacity < n) new_capacity *= 2;
+    const int old = number_of_pairs;
+
+    GrowArray(Org, old, new_capacity); GrowArray(Dest, old, new_capacity);
+    GrowArray(rij, old, new_capacity); GrowArray(Wij, old, new_capacity);
+    GrowArray(Fij, old, new_capacity); GrowArray(LapWij, old, new_capacity);
+    GrowArray(eij, old, new_capacity);
+    GrowArray(shear_rij, old, new_capacity); GrowArray(bulk_rij, old, new_capacity);
+    //the temporary terms are recomputed at every use
+    GrowArray(random_p, 0, new_capacity); GrowArray(random_v, 0, new_capacity);
+#ifdef _OPENMP
+    GrowArray(drhodt1, 0, new_capacity); GrowArray(drhodt2, 0, new_capacity);
+    GrowArray(_dU1, 0, new_capacity); GrowArray(_dU2, 0, new_capacity);
+    GrowArray(dUdt1, 0, new_capacity); GrowArray(dUdt2, 0, new_capacity);
+#endif
 
+    capacity = new_capacity;
+}
 //----------------------------------------------------------------------------------------
-//      use old interaction object for new interaction
+//                                      start a new pair list
 //----------------------------------------------------------------------------------------
-void Interaction::NewInteraction(Particle *prtl_org, Particle *prtl_dest, Force **forces,
-                                 QuinticSpline &weight_function, double dstc)
+void Interaction::NewList(Force **forces, QuinticSpline &weight_function)
 {
-    //the original and the destinate particle in the reaction pair
-    Org = prtl_org;
-    Dest = prtl_dest;
-        
-    //interaction parameters
-    noi = Org->mtl->number;
-    noj = Dest->mtl->number; 
     frc_ij = forces;
-
-    //define pair values do not change in sub time steps
-    mi = Org->m; mj = Dest->m;
-    rmi = 1.0/mi; rmj =1.0/mj;
-    etai = Org->eta; etaj = Dest->eta; 
-    zetai = Org->zeta; zetaj = Dest->zeta; 
-
-    //the pair parameters
-    rij = dstc;
-    rrij = 1.0/(rij + 1.0e-30);
-    eij = (Org->R - Dest->R)*rrij;
-    Wij = weight_function.w(rij);
-//      Fij = weight_function.F(rij); //for BetaSpline wight fuction
-    Fij = weight_function.F(rij)*rrij; //for QuinticSpline wight fuction
-    LapWij = weight_function.LapW(rij); //for QuinticSpline fuction
-    shear_rij = 2.0*etai*etaj*rij/(etai*(rij + 2.0*frc_ij[noj][noi].shear_slip) 
-                                   + etaj*(rij + 2.0*frc_ij[noi][noj].shear_slip) + 1.0e-30);
-    bulk_rij =  2.0*zetai*zetaj*rij/(zetai*(rij + 2.0*frc_ij[noj][noi].bulk_slip) 
-                                     + zetaj*(rij + 2.0*frc_ij[noi][noj].bulk_slip) + 1.0e-30);
+    this->weight_function = &weight_function;
+    //tabulate the kernel once
+    if(ini.kernel_table_size > 0 && kernel_table == 0) 
+        kernel_table = new KernelTable<QuinticSpline>(weight_function, smoothinglength, 
+                                                      ini.kernel_table_size, ini.kernel_table_order);
+    number_of_pairs = 0;
+    number_of_colours = 0;
 }
+//----------------------------------------------------------------------------------------
+//                                      set the number of pairs
+//----------------------------------------------------------------------------------------
+void Interaction::Resize(int n)
+{
+    Reserve(n);
+    number_of_pairs = n;
+}
+//----------------------------------------------------------------------------------------
+//              apply two pair summations in as few sweeps over the pairs as possible
+//              the second one joins the sweep of the first one, if it does not use 
+//              particle data the first one changes and the first one does not use particle 
+//              data it changes and they do not change the same particle data
+//----------------------------------------------------------------------------------------
+template <class First, class Second> 
+void Interaction::Sweep()
+{
+    const int particle_writes = (First::writes | Second::writes) & ~PAIR_VALUES;
+    if((particle_writes & (First::reads | Second::reads)) == 0 
+       && (First::writes & Second::writes & ~PAIR_VALUES) == 0) 
+        Sweep<Fused<First, Second> >();
+    else {
+        Sweep<First>();
+        Sweep<Second>();
+    }
+}
+//----------------------------------------------------------------------------------------
+//                              apply one pair summation
+//                      the tabulated or the analytic kernel is chosen once per sweep
+//----------------------------------------------------------------------------------------
+template <class PairSummation> 
+void Interaction::Sweep()
+{
+    if(kernel_table) SweepPairs<PairSummation>(*kernel_table);
+    else SweepPairs<PairSummation>(*weight_function);
+}
+//----------------------------------------------------------------------------------------
+//              one sweep of a pair summation over the pairs
+//              the summation and the kernel are known at compile time, 
+//              so the loop body is a direct call
+//----------------------------------------------------------------------------------------
+template <class PairSummation, class KernelType> 
+void Interaction::SweepPairs(const KernelType &kernel)
+{
+    int c, k;
+
+    //coloured pairs, batch by batch
+    if(number_of_colours > 0) {
+        for(c = 0; c < number_of_colours; c++) {
+            const int first_pair = colour_start[c], last_pair = colour_start[c + 1];
+            //pairs without a free colour may share particles
+            if(c == MAX_COLOURS) {
+                for(k = first_pair; k < last_pair; k++) PairSummation::Apply(*this, k, kernel);
+                continue;
+            }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for(k = first_pair; k < last_pair; k++) PairSummation::Apply(*this, k, kernel);
+        }
+        return;
+    }
 
-
+#ifdef _OPENMP
+    //without colours the pair forces are kept in the pairs and summed up afterwards,
+    //so a sweep which changes nothing else but pair data runs in parallel;
+    //the sums are taken in the pair order as in the serial sweep, for any number of threads
+    if(PairSummation::gathers && (PairSummation::writes & ~(PAIR_VALUES | CHANGE_RATE)) == 0) {
+#pragma omp parallel for
+        for(k = 0; k < number_of_pairs; k++) PairSummation::Apply(*this, k, kernel);
+        for(k = 0; k < number_of_pairs; k++) PairSummation::Gather(*this, k);
+        return;
+    }
+    if((PairSummation::writes & ~PAIR_VALUES) == 0) {
+#pragma omp parallel for
+        for(k = 0; k < number_of_pairs; k++) PairSummation::Apply(*this, k, kernel);
+        return;
+    }
+#endif
+    //serial sweep
+    for(k = 0; k < number_of_pairs; k++) PairSummation::Apply(*this, k, kernel);
+}
 //----------------------------------------------------------------------------------------
-//renew pair parameters and changing pair values
+//              renew the pair values with a kernel known at compile time
 //----------------------------------------------------------------------------------------
-// Changes: Interaction object
-// Depends on: Interaction Object, Org, Dest
-void Interaction::RenewInteraction(QuinticSpline &weight_function)
+template <class KernelType> 
+void Interaction::RenewPair(int k, const KernelType &kernel)
 {
+    //pair values do not change in sub time steps
+    const double etai = store->eta[Org[k]], etaj = store->eta[Dest[k]];
+    const double zetai = store->zeta[Org[k]], zetaj = store->zeta[Dest[k]];
+    const int noi = store->mtl[Org[k]]->number, noj = store->mtl[Dest[k]]->number;
+
     //the pair parameters
-    rij = v_abs(Org->R - Dest->R);
-    rrij = 1.0/(rij + 1.0e-30);
-    eij = (Org->R - Dest->R)*rrij;
-    Wij = weight_function.w(rij);
-//      Fij = weight_function.F(rij); //for BetaSpline wight fuction
-    Fij = weight_function.F(rij)*rrij; //for QuinticSpline fuction
-    LapWij = weight_function.LapW(rij); //for QuinticSpline fuction
-    shear_rij = 2.0*etai*etaj*rij/(etai*(rij + 2.0*frc_ij[noj][noi].shear_slip) 
-                                   + etaj*(rij + 2.0*frc_ij[noi][noj].shear_slip) + 1.0e-30);
-    bulk_rij =  2.0*zetai*zetaj*rij/(zetai*(rij + 2.0*frc_ij[noj][noi].bulk_slip) 
-                                     + zetaj*(rij + 2.0*frc_ij[noi][noj].bulk_slip) + 1.0e-30);
+    const Vec2d Rij = store->Separation(Org[k], Dest[k]);
+    const double r = v_abs(Rij);
+    const double rrij = 1.0/(r + 1.0e-30);
+    rij[k] = r;
+    eij[k] = Rij*rrij;
+    kernel.Values(r, Wij[k], Fij[k], LapWij[k]);
+    shear_rij[k] = 2.0*etai*etaj*r/(etai*(r + 2.0*frc_ij[noj][noi].shear_slip) 
+                                    + etaj*(r + 2.0*frc_ij[noi][noj].shear_slip) + 1.0e-30);
+    bulk_rij[k] =  2.0*zetai*zetaj*r/(zetai*(r + 2.0*frc_ij[noj][noi].bulk_slip) 
+                                      + zetaj*(r + 2.0*frc_ij[noi][noj].bulk_slip) + 1.0e-30);
 }
 //----------------------------------------------------------------------------------------
 //                                      summation the density
@@ -140,11 +227,13 @@ void Interaction::RenewInteraction(QuinticSpline &weight_function)
 //----------------------------------------------------------------------------------------
 // Changes: Org(rho:summation), Dest(rho:summation)
 // Depends on: Interaction Object, Org(rho), Dest(rho)
-void Interaction::SummationDensity()
+void Interaction::SummationDensity(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
     //summation
-    Org->rho += mi*Wij;
-    if(Org->ID != Dest->ID) Dest->rho += mj*Wij; 
+    store->rho[Org[k]] += mi*Wij[k];
+    if(store->ID[Org[k]] != store->ID[Dest[k]]) store->rho[Dest[k]] += mj*Wij[k]; 
 
 }
 //----------------------------------------------------------------------------------------
@@ -152,213 +241,258 @@ void Interaction::SummationDensity()
 //----------------------------------------------------------------------------------------
 // Changes: Org(ShearRate_x, ShearRate_y:summation), Dest(ShearRate_x, ShearRate_y:summation)
 // Depends on: Interaction Object, Org(ShearRate_x, ShearRate_y, U, rho), Dest(ShearRate_x, ShearRate_y, U, rho)
-void Interaction::SummationShearRate()
+void Interaction::SummationShearRate(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
     //pair particle state values
     double vi, vj; //particle volumes
     Vec2d Uij; //velocity, velocity difference and midddle point velocity
     Vec2d ShearRate_xi, ShearRate_yi; //shear rates
                 
     //define particle state values
-    vi = mi/Org->rho; vj = mj/Dest->rho;
-    Uij = Org->U - Dest->U;
-    ShearRate_xi = Uij*eij[0]*Fij*rij;
-    ShearRate_yi = Uij*eij[1]*Fij*rij;
+    vi = mi/store->rho[Org[k]]; vj = mj/store->rho[Dest[k]];
+    Uij = store->U[Org[k]] - store->U[Dest[k]];
+    ShearRate_xi = Uij*eij[k][0]*Fij[k]*rij[k];
+    ShearRate_yi = Uij*eij[k][1]*Fij[k]*rij[k];
         
     //summation
-    Org->ShearRate_x = Org->ShearRate_x + ShearRate_xi*vj;
-    Org->ShearRate_y = Org->ShearRate_y + ShearRate_yi*vj;
-    Dest->ShearRate_x = Dest->ShearRate_x + ShearRate_xi*vi;
-    Dest->ShearRate_y = Dest->ShearRate_y + ShearRate_yi*vi;
+    store->ShearRate_x[Org[k]] = store->ShearRate_x[Org[k]] + ShearRate_xi*vj;
+    store->ShearRate_y[Org[k]] = store->ShearRate_y[Org[k]] + ShearRate_yi*vj;
+    store->ShearRate_x[Dest[k]] = store->ShearRate_x[Dest[k]] + ShearRate_xi*vi;
+    store->ShearRate_y[Dest[k]] = store->ShearRate_y[Dest[k]] + ShearRate_yi*vi;
 }
 //----------------------------------------------------------------------------------------
 //                                              phase field
 //----------------------------------------------------------------------------------------
 // Changes: Org(phi:summation), Dest(phi:summation)
 // Depends on: Interaction Object, Org(phi, rho), Dest(phi, rho)
-void Interaction::SummationPhaseField()
+void Interaction::SummationPhaseField(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const int noi = store->mtl[Org[k]]->number, noj = store->mtl[Dest[k]]->number;
     double vi, vj; //particle volumes
-    vi = mi/Org->rho; vj = mj/Dest->rho;
+    vi = mi/store->rho[Org[k]]; vj = mj/store->rho[Dest[k]];
 
-    Org->phi[noi][noj] += Wij*vj;
-    if(Org->ID != Dest->ID) Dest->phi[noj][noi] += Wij*vi;
+    store->Phi(Org[k])[noi*number_of_materials + noj] += Wij[k]*vj;
+    if(store->ID[Org[k]] != store->ID[Dest[k]]) store->Phi(Dest[k])[noj*number_of_materials + noi] += Wij[k]*vi;
 }
 //----------------------------------------------------------------------------------------
 //                                              density or phase gradient
 //----------------------------------------------------------------------------------------
 // Changes: Org(del_phi:summation), Dest(del_phi:summation)
 // Depends on: Interaction Object, Org(del_phi,rho), Dest(del_phi,rho)
-void Interaction::SummationPhaseGradient()
+void Interaction::SummationPhaseGradient(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const int noi = store->mtl[Org[k]]->number, noj = store->mtl[Dest[k]]->number;
 
     double Vi, rVi, Vj, rVj; //mometum change rate
-    Vi = mi/Org->rho; Vj = mj/Dest->rho;
+    Vi = mi/store->rho[Org[k]]; Vj = mj/store->rho[Dest[k]];
     rVi = 1.0/Vi; rVj = 1.0/Vj;
     double Vi2 = Vi*Vi, Vj2 = Vj*Vj;
-    Vec2d dphi = eij*Fij*rij*frc_ij[noi][noj].sigma;
+    Vec2d dphi = eij[k]*Fij[k]*rij[k]*frc_ij[noi][noj].sigma;
 
-    Org->del_phi += dphi*rVi*Vj2;
-    Dest->del_phi -= dphi*rVj*Vi2;
+    store->del_phi[Org[k]] += dphi*rVi*Vj2;
+    store->del_phi[Dest[k]] -= dphi*rVj*Vi2;
 }
 //----------------------------------------------------------------------------------------
 //                                              phase field Laplacian
 //----------------------------------------------------------------------------------------
-void Interaction::SummationPhaseLaplacian()
+void Interaction::SummationPhaseLaplacian(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const int noi = store->mtl[Org[k]]->number, noj = store->mtl[Dest[k]]->number;
     //pair particle state values
     double vi, vj; //particle volumes
     double lapi;
                 
     //define particle state values
-    vi = mi/Org->rho; vj = mj/Dest->rho;
-    lapi = LapWij;
+    vi = mi/store->rho[Org[k]]; vj = mj/store->rho[Dest[k]];
+    lapi = LapWij[k];
         
     //summation
-    Org->lap_phi[noi][noj] += lapi*vj;
-    Dest->lap_phi[noj][noi] += lapi*vi;
+    store->LapPhi(Org[k])[noi*number_of_materials + noj] += lapi*vj;
+    store->LapPhi(Dest[k])[noj*number_of_materials + noi] += lapi*vi;
 }
 //----------------------------------------------------------------------------------------
 //                                      Curvature
 //----------------------------------------------------------------------------------------
-void Interaction::SummationCurvature()
+void Interaction::SummationCurvature(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const int noi = store->mtl[Org[k]]->number, noj = store->mtl[Dest[k]]->number;
     double vi, vj; //particle volumes
-    vi = mi/Org->rho; vj = mj/Dest->rho;
-    double phii = Fij*rij;
+    vi = mi/store->rho[Org[k]]; vj = mj/store->rho[Dest[k]];
+    double phii = Fij[k]*rij[k];
 
-    Org->phi[noi][noj] += phii*vj;
-    Dest->phi[noj][noi] += phii*vi;
+    store->Phi(Org[k])[noi*number_of_materials + noj] += phii*vj;
+    store->Phi(Dest[k])[noj*number_of_materials + noi] += phii*vi;
 }
 //----------------------------------------------------------------------------------------
-//                                      update pair forces
+//              pair forces: momentum, normalized velocity and density change rates
 //----------------------------------------------------------------------------------------
-void Interaction::UpdateForces()
-{       
+void Interaction::PairForce(int k, Vec2d &dPdti, Vec2d &dUi, double &drhodti) const
+{
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
     //pressure, density and inverse density and middle point pressure
-    double pi, rhoi, Vi, rVi, pj, rhoj, Vj, rVj, Uijdoteij; 
+    double pi, rhoi, Vi, pj, rhoj, Vj, Uijdoteij; 
     //velocity and velocity difference
     Vec2d Ui, Uj, Uij; 
 
     //define pair values change in sub time steps
-    rhoi = Org->rho; rhoj = Dest->rho;
+    rhoi = store->rho[Org[k]]; rhoj = store->rho[Dest[k]];
     Vi = mi/rhoi; Vj = mj/rhoj;
-    rVi = 1.0/Vi; rVj = 1.0/Vj;
-    pi = Org->p; pj = Dest->p;
-    Ui = Org->U; Uj = Dest->U;
+    pi = store->p[Org[k]]; pj = store->p[Dest[k]];
+    Ui = store->U[Org[k]]; Uj = store->U[Dest[k]];
     Uij = Ui - Uj;
-    Uijdoteij = dot(Uij, eij);
+    Uijdoteij = dot(Uij, eij[k]);
 
-    //pair focres or change rate
-    Vec2d dPdti, dUi; //mometum change rate
-    double drhodti; //density change rate
     double Vi2 = Vi*Vi, Vj2 = Vj*Vj;
     //artificial viscosity or Neumann_Richtmyer viscosity
     double theta, Csi, Csj, NR_vis;
-    extern double k_bltz;
-    Csi = Org->Cs; Csj = Dest->Cs;
-    theta = Uijdoteij*rij*delta/(rij*rij + 0.01*delta*delta);
+    Csi = store->Cs[Org[k]]; Csj = store->Cs[Dest[k]];
+    theta = Uijdoteij*rij[k]*delta/(rij[k]*rij[k] + 0.01*delta*delta);
     NR_vis = Uijdoteij > 0.0 ? 0.0 : art_vis*theta*(rhoi*Csi*mj + rhoj*Csj*mi)/(mi + mj);
         
     //normalize velocity
-    dUi = - eij*theta*Wij*art_vis/(rhoi + rhoj);
+    dUi = - eij[k]*theta*Wij[k]*art_vis/(rhoi + rhoj);
 
     //density change rate
-    drhodti = - Fij*rij*dot((Ui*Vi2 - Uj*Vj2), eij);
+    drhodti = - Fij[k]*rij[k]*dot((Ui*Vi2 - Uj*Vj2), eij[k]);
 
     //momentum change rate
-    dPdti =   eij*Fij*rij*(pi*Vi2 + pj*Vj2)
-        - ((Uij - eij*Uijdoteij)*shear_rij + eij*(Uijdoteij*2.0*bulk_rij + NR_vis))
-        *Fij*(Vi2 + Vj2);
+    dPdti =   eij[k]*Fij[k]*rij[k]*(pi*Vi2 + pj*Vj2)
+        - ((Uij - eij[k]*Uijdoteij)*shear_rij[k] + eij[k]*(Uijdoteij*2.0*bulk_rij[k] + NR_vis))
+        *Fij[k]*(Vi2 + Vj2);
 	
-	// polymer force
-	if ( Org->polyID>0  && Dest->polyID>0 ) {
-
-		if ( abs(Org->polyID - Dest->polyID) == 1 ) {
-			//std::cerr << "Org->polyID = " << Org->polyID << " Dest->polyID = " << Dest->polyID << '\n';
-			const double relR = rij/ini.polymer_r0;
-                      
-                        if (relR>1.0) {
-                         std::cerr << __FILE__ << ':' << __LINE__ << ": ERROR: polymer is broken\n" ;
-                          std::cerr << "rij  = " << rij << std::endl;
-                          std::cerr << "ini.box_size:  " << ini.box_size << std::endl;
-                         std::cerr << "ini.polymer_r0  = " << ini.polymer_r0 << std::endl;
-                           std::cerr << "ini.polymer_H  = " << ini.polymer_H << std::endl;
-                          std::cerr << "H*r0^2/kt  = " << ini.polymer_H * ini.polymer_r0 * ini.polymer_r0 / (k_bltz * Org->T) << std::endl;
-                         std::cerr << "relR  = " << relR << std::endl;
-                         std::cerr << "Org->R: " << Org->R << std::endl;
-                          std::cerr << "Dest->R: " << Dest->R << std::endl;
-                          std::cerr << "Org->polyID: " << Org->polyID << std::endl;
-                          std::cerr << "Dest->polyID: " << Dest->polyID << std::endl;
-                         exit(EXIT_FAILURE);
-                         
-                        }
-                        
-		dPdti -= ini.polymer_H / ( 1 -  relR*relR) * (rij * eij);
-    //dPdti += -ini.polymer_H * (rij * eij);
-			
-		}
-	}
-        
     //surface tension with a simple model
-//      dPdti += eij*frc_ij[noi][noj].sigma*Fij*Wij*rij*(Vi2 + Vj2);
+//      dPdti += eij[k]*frc_ij[noi][noj].sigma*Fij[k]*Wij[k]*rij[k]*(Vi2 + Vj2);
 
     //surface tension with simplified model
     Vec2d Surfi, Surfj, SurfaceForcei, SurfaceForcej;
-    Surfi = Org->del_phi; Surfj = Dest->del_phi;
+    Surfi = store->del_phi[Org[k]]; Surfj = store->del_phi[Dest[k]];
+
+    SurfaceForcei[0] = Surfi[0]*eij[k][0] + Surfi[1]*eij[k][1];
+    SurfaceForcei[1] = Surfi[1]*eij[k][0] - Surfi[0]*eij[k][1];
+    SurfaceForcej[0] = Surfj[0]*eij[k][0] + Surfj[1]*eij[k][1];
+    SurfaceForcej[1] = Surfj[1]*eij[k][0] - Surfj[0]*eij[k][1];
+    dPdti +=  (SurfaceForcei*Vi2 + SurfaceForcej*Vj2)*rij[k]*Fij[k];
+}
+//----------------------------------------------------------------------------------------
+//                                      update pair forces
+//----------------------------------------------------------------------------------------
+void Interaction::UpdateForces(int k)
+{
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const double rmi = 1.0/mi, rmj = 1.0/mj;
+    const double rhoi = store->rho[Org[k]], rhoj = store->rho[Dest[k]];
+    const double rVi = 1.0/(mi/rhoi), rVj = 1.0/(mj/rhoj);
 
-    SurfaceForcei[0] = Surfi[0]*eij[0] + Surfi[1]*eij[1];
-    SurfaceForcei[1] = Surfi[1]*eij[0] - Surfi[0]*eij[1];
-    SurfaceForcej[0] = Surfj[0]*eij[0] + Surfj[1]*eij[1];
-    SurfaceForcej[1] = Surfj[1]*eij[0] - Surfj[0]*eij[1];
-    dPdti +=  (SurfaceForcei*Vi2 + SurfaceForcej*Vj2)*rij*Fij;
+    //pair focres or change rate
+    Vec2d dPdti, dUi; //mometum change rate
+    double drhodti; //density change rate
+    PairForce(k, dPdti, dUi, drhodti);
 
     //summation
 #ifdef _OPENMP
-    _dU1 = dUi*mi;
-    _dU2 = dUi*mj;
-    drhodt1 = drhodti*rhoi*rVi;
-    drhodt2 = drhodti*rhoj*rVj;
-    dUdt1 = dPdti*rmi;
-    dUdt2 = dPdti*rmj;
-#else
-    Org->_dU += dUi*mi;
-    Dest->_dU -= dUi*mj;
-    Org->drhodt += drhodti*rhoi*rVi;
-    Dest->drhodt += drhodti*rhoj*rVj;
-    Org->dUdt += dPdti*rmi;
-    Dest->dUdt -= dPdti*rmj;
+    //without colours the pair terms are summed up later by SummationUpdateForces()
+    if(number_of_colours == 0) {
+        _dU1[k] = dUi*mi;
+        _dU2[k] = dUi*mj;
+        drhodt1[k] = drhodti*rhoi*rVi;
+        drhodt2[k] = drhodti*rhoj*rVj;
+        dUdt1[k] = dPdti*rmi;
+        dUdt2[k] = dPdti*rmj;
+        return;
+    }
 #endif
+    store->_dU[Org[k]] += dUi*mi;
+    store->_dU[Dest[k]] -= dUi*mj;
+    store->drhodt[Org[k]] += drhodti*rhoi*rVi;
+    store->drhodt[Dest[k]] += drhodti*rhoj*rVj;
+    store->dUdt[Org[k]] += dPdti*rmi;
+    store->dUdt[Dest[k]] -= dPdti*rmj;
 }
 
 #ifdef _OPENMP
-void Interaction::SummationUpdateForces()
+void Interaction::SummationUpdateForces(int k)
 {
-    Org->_dU += _dU1;
-    Dest->_dU -= _dU2;
-    Org->drhodt += drhodt1;
-    Dest->drhodt += drhodt2;
-    Org->dUdt += dUdt1;
-    Dest->dUdt -= dUdt2;
+    store->_dU[Org[k]] += _dU1[k];
+    store->_dU[Dest[k]] -= _dU2[k];
+    store->drhodt[Org[k]] += drhodt1[k];
+    store->drhodt[Dest[k]] += drhodt2[k];
+    store->dUdt[Org[k]] += dUdt1[k];
+    store->dUdt[Dest[k]] -= dUdt2[k];
 }
 #endif
+//----------------------------------------------------------------------------------------
+//              a real fluid particle or a periodic ghost of one
+//----------------------------------------------------------------------------------------
+inline bool Interaction::Fluid(int n) const
+{
+    if(n < store->number_of_real) return store->bd[n] == 0;
+    return store->bd_type[n] == 1 && store->bd[store->rl_prtl[n]] == 0;
+}
+//----------------------------------------------------------------------------------------
+//              symmetric xy virial of the pair forces between fluid particles
+//----------------------------------------------------------------------------------------
+double Interaction::ShearVirial() const
+{
+    int b, k;
+    double virial = 0.0;
+    //the pairs are summed up in fixed blocks and the block sums in the block order,
+    //so the result does not depend on the number of threads
+    double block_virial[VIRIAL_BLOCKS];
+
+#ifdef _OPENMP
+#pragma omp parallel for private(k)
+#endif
+    for(b = 0; b < VIRIAL_BLOCKS; b++) {
+        const int first = int((long)number_of_pairs*b/VIRIAL_BLOCKS);
+        const int last = int((long)number_of_pairs*(b + 1)/VIRIAL_BLOCKS);
+        block_virial[b] = 0.0;
+        for(k = first; k < last; k++) {
+            //only the pairs of two fluid particles, the walls and their images are left out
+            if(!Fluid(Org[k]) || !Fluid(Dest[k])) continue;
+            //a pair with a periodic ghost is found again from the other side of the boundary
+            const double share = store->bd_type[Org[k]] == 1 || store->bd_type[Dest[k]] == 1 ? 0.5 : 1.0;
+
+            Vec2d dPdti, dUi;
+            double drhodti;
+            PairForce(k, dPdti, dUi, drhodti);
+            block_virial[b] += share*0.5*rij[k]*(eij[k][0]*dPdti[1] + eij[k][1]*dPdti[0]);
+        }
+    }
+    for(b = 0; b < VIRIAL_BLOCKS; b++) virial += block_virial[b];
+    return virial;
+}
 
 //----------------------------------------------------------------------------------------
 //                              update forces with summation viscosity
 //----------------------------------------------------------------------------------------
-void Interaction::UpdateForces_vis()
+void Interaction::UpdateForces_vis(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const double etai = store->eta[Org[k]], etaj = store->eta[Dest[k]];
+    const double zetai = store->zeta[Org[k]], zetaj = store->zeta[Dest[k]];
     //pressure, density and inverse density and middle point pressure
     double pi, rhoi, rrhoi, pj, rhoj, rrhoj, _pij; 
     //velocity, velocity difference and midddle point velocity
     Vec2d Ui, Uj, Uij, _Uij; 
 
     //define pair values change in sub time steps
-    rhoi = Org->rho; rhoj = Dest->rho;
+    rhoi = store->rho[Org[k]]; rhoj = store->rho[Dest[k]];
     rrhoi = 1.0/rhoi; rrhoj = 1.0/rhoj;
-    pi = Org->p; pj = Dest->p;
-    Ui = Org->U; Uj = Dest->U;
-    Uij = Org->U - Dest->U;
+    pi = store->p[Org[k]]; pj = store->p[Dest[k]];
+    Ui = store->U[Org[k]]; Uj = store->U[Dest[k]];
+    Uij = store->U[Org[k]] - store->U[Dest[k]];
     _pij = (pi + pj)*0.5;
     _Uij = (Ui + Uj)*0.5;
 
@@ -372,8 +506,8 @@ void Interaction::UpdateForces_vis()
     Vec2d dPdti; //mometum change rate
 
     //shear force
-    ShearRate_xi = Org->ShearRate_x; ShearRate_yi =  Org->ShearRate_y;
-    ShearRate_xj = Dest->ShearRate_x; ShearRate_yj =  Dest->ShearRate_y;
+    ShearRate_xi = store->ShearRate_x[Org[k]]; ShearRate_yi =  store->ShearRate_y[Org[k]];
+    ShearRate_xj = store->ShearRate_x[Dest[k]]; ShearRate_yj =  store->ShearRate_y[Dest[k]];
 
     ShearStress[0][0] = (ShearRate_xi[0] + ShearRate_xj[0]);
     ShearStress[0][1] = ((ShearRate_xi[1] + ShearRate_xj[1]) + (ShearRate_yi[0] + ShearRate_yj[0]))*0.5;
@@ -382,25 +516,28 @@ void Interaction::UpdateForces_vis()
     CompressRate = (ShearStress[0][0] + ShearStress[1][1])/3.0;
     ShearStress[0][0] -= CompressRate;  ShearStress[1][1] -= CompressRate;
 
-    ShearForce[0] = ShearStress[0][0]*eij[0] + ShearStress[1][0]*eij[1]; 
-    ShearForce[1] = ShearStress[0][1]*eij[0] + ShearStress[1][1]*eij[1]; 
+    ShearForce[0] = ShearStress[0][0]*eij[k][0] + ShearStress[1][0]*eij[k][1]; 
+    ShearForce[1] = ShearStress[0][1]*eij[k][0] + ShearStress[1][1]*eij[k][1]; 
     ShearForce = ShearForce*2.0*etai*etaj/(etai + etaj) 
-        + eij*CompressRate*2.0*zetai*zetaj/(zetai + zetaj); 
+        + eij[k]*CompressRate*2.0*zetai*zetaj/(zetai + zetaj); 
 
         
     //define pair force or change rates
-    dPdti =   eij*Fij*rij*_pij*(rrhoi*rrhoi + rrhoj*rrhoj)
-        - ShearForce*Fij*rij*(rrhoi*rrhoi + rrhoj*rrhoj);
+    dPdti =   eij[k]*Fij[k]*rij[k]*_pij*(rrhoi*rrhoi + rrhoj*rrhoj)
+        - ShearForce*Fij[k]*rij[k]*(rrhoi*rrhoi + rrhoj*rrhoj);
     //summation
-    Org->dUdt = Org->dUdt + dPdti*mj;
-    Dest->dUdt = Dest->dUdt - dPdti*mi;
+    store->dUdt[Org[k]] = store->dUdt[Org[k]] + dPdti*mj;
+    store->dUdt[Dest[k]] = store->dUdt[Dest[k]] - dPdti*mi;
 
 }
 //----------------------------------------------------------------------------------------
 //                                      update random forces
 //----------------------------------------------------------------------------------------
-void Interaction::RandomForces(Wiener &wiener, double sqrtdt)
+void Interaction::RandomForces(int k)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const double rmi = 1.0/mi, rmj = 1.0/mj;
     //pair particle state values
     double Vi, Vj; 
     double Ti, Tj; //temperature
@@ -409,34 +546,60 @@ void Interaction::RandomForces(Wiener &wiener, double sqrtdt)
     extern double k_bltz;
 
     //define particle state values
-    Vi = mi/Org->rho; Vj = mj/Dest->rho;
-    Ti =Org->T; Tj = Dest->T;
-        
-    wiener.get_wiener(sqrtdt);
+    Vi = mi/store->rho[Org[k]]; Vj = mj/store->rho[Dest[k]];
+    Ti =store->T[Org[k]]; Tj = store->T[Dest[k]];
+    v_eij[0] = -eij[k][1]; v_eij[1] = eij[k][0];
 
     //pair focres or change rate
     Vec2d _dUi; //mometum change rate
     double Vi2 = Vi*Vi, Vj2 = Vj*Vj;
 
-    _dUi = v_eij*wiener.Random_p*sqrt(16.0*k_bltz*shear_rij*Ti*Tj/(Ti + Tj)*(Vi2 + Vj2)*Fij) +
-        eij*wiener.Random_v*sqrt(16.0*k_bltz*bulk_rij*Ti*Tj/(Ti + Tj)*(Vi2 + Vj2)*Fij);
+    _dUi = v_eij*random_p[k]*sqrt(16.0*k_bltz*shear_rij[k]*Ti*Tj/(Ti + Tj)*(Vi2 + Vj2)*Fij[k]) +
+        eij[k]*random_v[k]*sqrt(16.0*k_bltz*bulk_rij[k]*Ti*Tj/(Ti + Tj)*(Vi2 + Vj2)*Fij[k]);
 
     //summation
+#ifdef _OPENMP
+    //without colours the pair terms are summed up later by SummationRandomForces()
+    if(number_of_colours == 0) {
+        if(store->bd_type[Dest[k]] == 1) {
+            _dU1[k] = _dUi*rmi*0.5;
+            _dU2[k] = _dUi*rmj*0.5;
+        }
+        else {
+            _dU1[k] = _dUi*rmi;
+            _dU2[k] = _dUi*rmj;
+        }
+        return;
+    }
+#endif
     //modify for perodic boundary condition
-    if(Dest->bd_type == 1) {
-        Org->_dU        = Org->_dU + _dUi*rmi*0.5;
-        Dest->rl_prtl->_dU      = Dest->rl_prtl->_dU - _dUi*rmj*0.5;
+    if(store->bd_type[Dest[k]] == 1) {
+        store->_dU[Org[k]]        = store->_dU[Org[k]] + _dUi*rmi*0.5;
+        store->_dU[store->rl_prtl[Dest[k]]]      = store->_dU[store->rl_prtl[Dest[k]]] - _dUi*rmj*0.5;
     }
     else {
-        Org->_dU = Org->_dU + _dUi*rmi;
-        Dest->_dU = Dest->_dU - _dUi*rmj;
+        store->_dU[Org[k]] = store->_dU[Org[k]] + _dUi*rmi;
+        store->_dU[Dest[k]] = store->_dU[Dest[k]] - _dUi*rmj;
     }
 }
+
+#ifdef _OPENMP
+void Interaction::SummationRandomForces(int k)
+{
+    const int j = store->bd_type[Dest[k]] == 1 ? store->rl_prtl[Dest[k]] : Dest[k];
+    store->_dU[Org[k]] = store->_dU[Org[k]] + _dU1[k];
+    store->_dU[j] = store->_dU[j] - _dU2[k];
+}
+#endif
 //----------------------------------------------------------------------------------------
 //                                      update random forces with Espanol's method
 //----------------------------------------------------------------------------------------
-void Interaction::RandomForces_Espanol(Wiener &wiener, double sqrtdt)
+void Interaction::RandomForces_Espanol(int k, Wiener &wiener, double sqrtdt)
 {
+    //pair values do not change in sub time steps
+    const double mi = store->m[Org[k]], mj = store->m[Dest[k]];
+    const double etai = store->eta[Org[k]], etaj = store->eta[Dest[k]];
+    const double zetai = store->zeta[Org[k]], zetaj = store->zeta[Dest[k]];
     //pair particle state values
     double smimj, smjmi, rrhoi, rrhoj; 
     double Ti, Tj; //temperature
@@ -449,26 +612,40 @@ void Interaction::RandomForces_Espanol(Wiener &wiener, double sqrtdt)
 
     //define particle state values
     smimj = sqrt(mi/mj); smjmi = 1.0/smimj;
-    rrhoi = 1.0/Org->rho; rrhoj = 1.0/Dest->rho;
-    Ti =Org->T; Tj = Dest->T;
+    rrhoi = 1.0/store->rho[Org[k]]; rrhoj = 1.0/store->rho[Dest[k]];
+    Ti =store->T[Org[k]]; Tj = store->T[Dest[k]];
         
     wiener.get_wiener_Espanol(sqrtdt);
 
-    random_force[0] = wiener.sym_trclss[0][0]*eij[0] + wiener.sym_trclss[0][1]*eij[1];
-    random_force[1] = wiener.sym_trclss[1][0]*eij[0] + wiener.sym_trclss[1][1]*eij[1];
+    random_force[0] = wiener.sym_trclss[0][0]*eij[k][0] + wiener.sym_trclss[0][1]*eij[k][1];
+    random_force[1] = wiener.sym_trclss[1][0]*eij[k][0] + wiener.sym_trclss[1][1]*eij[k][1];
 
-    _dUi = random_force*sqrt(16.0*k_bltz*etai*etaj/(etai + etaj)*Ti*Tj/(Ti + Tj)*(rrhoi*rrhoi + rrhoj*rrhoj)*Fij) +
-        eij*wiener.trace_d*sqrt(16.0*k_bltz*zetai*zetaj/(zetai + zetaj)*Ti*Tj/(Ti + Tj)*(rrhoi*rrhoi + rrhoj*rrhoj)*Fij);
+    _dUi = random_force*sqrt(16.0*k_bltz*etai*etaj/(etai + etaj)*Ti*Tj/(Ti + Tj)*(rrhoi*rrhoi + rrhoj*rrhoj)*Fij[k]) +
+        eij[k]*wiener.trace_d*sqrt(16.0*k_bltz*zetai*zetaj/(zetai + zetaj)*Ti*Tj/(Ti + Tj)*(rrhoi*rrhoi + rrhoj*rrhoj)*Fij[k]);
 
     //summation
     //modify for perodic boundary condition
-    if(Dest->bd_type == 1) {
-        Org->_dU        = Org->_dU + _dUi*smjmi*0.5;
-        Dest->rl_prtl->_dU      = Dest->rl_prtl->_dU - _dUi*smimj*0.5;
+    if(store->bd_type[Dest[k]] == 1) {
+        store->_dU[Org[k]]        = store->_dU[Org[k]] + _dUi*smjmi*0.5;
+        store->_dU[store->rl_prtl[Dest[k]]]      = store->_dU[store->rl_prtl[Dest[k]]] - _dUi*smimj*0.5;
     }
     else {
-        Org->_dU        = Org->_dU + _dUi*smjmi;
-        Dest->_dU       = Dest->_dU - _dUi*smimj;
+        store->_dU[Org[k]]        = store->_dU[Org[k]] + _dUi*smjmi;
+        store->_dU[Dest[k]]       = store->_dU[Dest[k]] - _dUi*smimj;
     }
 
 }
+//----------------------------------------------------------------------------------------
+//                              the sweeps used by Hydrodynamics
+//----------------------------------------------------------------------------------------
+template void Interaction::Sweep<Interaction::Renew>();
+template void Interaction::Sweep<Interaction::Density>();
+template void Interaction::Sweep<Interaction::ShearRate>();
+template void Interaction::Sweep<Interaction::PhaseField>();
+template void Interaction::Sweep<Interaction::PhaseGradient>();
+template void Interaction::Sweep<Interaction::PhaseLaplacian>();
+template void Interaction::Sweep<Interaction::Forces>();
+template void Interaction::Sweep<Interaction::Random>();
+template void Interaction::Sweep<Interaction::Renew, Interaction::Density>();
+template void Interaction::Sweep<Interaction::Renew, Interaction::ShearRate>();
+template void Interaction::Sweep<Interaction::Renew, Interaction::Forces>();
@@ -1,15 +1,19 @@
-/// \file interaction.h 
+/// \file interaction.h
 /// \brief Defines interaction between particles
 
 #ifndef INTERACTION_H
 #define INTERACTION_H
 
-class Particle;
 class QuinticSpline;
 class Force;
 class Initiation;
+template <class KernelType> class KernelTable;
 
 /// Defines interaction between particles
+///
+/// All particle pairs are kept in flat arrays indexed by the pair number,
+/// in the order they are found in the cell grid.
+/// The arrays are reused and only grow from one time step to the next.
 class Interaction {
 	/// local reference to Initiation object
 	 Initiation& ini;
@@ -21,60 +25,180 @@ class Interaction {
     ///artificial viscosity
     static double art_vis;
 
-    ///particle pair
-    Particle *Org;      ///particel with larger ID
-    Particle *Dest;     ///particel with smaller ID
+    ///the particles the pair indices refer to
+    ParticleStore *store;
     Force **frc_ij;     ///force from particle i to particle j
-        
-    ///pair values do not change in sub time steps
-    int noi, noj; ///material NO. of the two partilces
-    double mi, rmi, etai, zetai, mj, rmj, etaj, zetaj;
+    QuinticSpline *weight_function; ///kernel for the pair values
+    ///tabulated weight_function, 0: the kernel is evaluated directly
+    KernelTable<QuinticSpline> *kernel_table;
+
+    ///length of the allocated arrays
+    int capacity;
+    ///grow all arrays to hold at least n pairs
+    void Reserve(int n);
+    ///renew the pair values with the kernel chosen at compile time
+    template <class KernelType> void RenewPair(int k, const KernelType &kernel);
+    ///one sweep of a pair summation over the pairs with the kernel chosen at compile time
+    template <class PairSummation, class KernelType> void SweepPairs(const KernelType &kernel);
+
+    ///momentum, normalized velocity and density change rates of the pair forces of pair k
+    void PairForce(int k, Vec2d &dPdti, Vec2d &dUi, double &drhodti) const;
+    ///a real fluid particle or a periodic ghost of one, not a wall or a wall image
+    bool Fluid(int n) const;
+    ///number of blocks of pairs summed up separately by ShearVirial()
+    enum { VIRIAL_BLOCKS = 64 };
+
+public:
+
+    ///data read or written by the pair summations
+    ///PAIR_VALUES are per pair and each pair only touches its own
+    enum PairData { PAIR_VALUES = 1, STATES = 2, DENSITY = 4, SHEAR_RATE = 8, PHASE_FIELD = 16,
+                    PHASE_GRADIENT = 32, PHASE_LAPLACIAN = 64, CHANGE_RATE = 128 };
+    ///the pair summations which can be combined into sweeps over the pairs:
+    ///the data each one depends on and changes, all of them also depend on the pair values
+    ///and on particle data no pair summation changes (position, mass, material);
+    ///Apply() does the work for pair k with the kernel of the sweep, Gather() sums up the pair terms kept by Apply() 
+    ///when the pairs are not coloured
+    struct Summation {
+        static const int gathers = 0;
+#ifdef _OPENMP
+        static void Gather(Interaction &, int) {}
+#endif
+    };
+    struct Renew : Summation {
+        static const int reads = 0, writes = PAIR_VALUES;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &kernel) { pairs.RenewPair(k, kernel); }
+    };
+    struct Density : Summation {
+        static const int reads = PAIR_VALUES, writes = DENSITY;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.SummationDensity(k); }
+    };
+    struct ShearRate : Summation {
+        static const int reads = PAIR_VALUES | DENSITY | STATES, writes = SHEAR_RATE;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.SummationShearRate(k); }
+    };
+    struct PhaseField : Summation {
+        static const int reads = PAIR_VALUES | DENSITY, writes = PHASE_FIELD;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.SummationPhaseField(k); }
+    };
+    struct PhaseGradient : Summation {
+        static const int reads = PAIR_VALUES | DENSITY, writes = PHASE_GRADIENT;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.SummationPhaseGradient(k); }
+    };
+    struct PhaseLaplacian : Summation {
+        static const int reads = PAIR_VALUES | DENSITY, writes = PHASE_LAPLACIAN;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.SummationPhaseLaplacian(k); }
+    };
+    struct Forces {
+        static const int reads = PAIR_VALUES | DENSITY | STATES | PHASE_GRADIENT, writes = CHANGE_RATE;
+        static const int gathers = 1;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.UpdateForces(k); }
+#ifdef _OPENMP
+        static void Gather(Interaction &pairs, int k) { pairs.SummationUpdateForces(k); }
+#endif
+    };
+    struct Random {
+        static const int reads = PAIR_VALUES | DENSITY | STATES, writes = CHANGE_RATE;
+        static const int gathers = 1;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &) { pairs.RandomForces(k); }
+#ifdef _OPENMP
+        static void Gather(Interaction &pairs, int k) { pairs.SummationRandomForces(k); }
+#endif
+    };
+    ///two pair summations done in one sweep over the pairs
+    template <class First, class Second> struct Fused {
+        static const int reads = First::reads | Second::reads, writes = First::writes | Second::writes;
+        static const int gathers = First::gathers | Second::gathers;
+        template <class KernelType> 
+        static void Apply(Interaction &pairs, int k, const KernelType &kernel) { 
+            First::Apply(pairs, k, kernel); Second::Apply(pairs, k, kernel); 
+        }
+#ifdef _OPENMP
+        static void Gather(Interaction &pairs, int k) { First::Gather(pairs, k); Second::Gather(pairs, k); }
+#endif
+    };
+
+    ///number of pairs in the list
+    int number_of_pairs;
+
+    ///largest number of colours, pairs which find no free colour go into one more batch
+    ///which is summed up serially
+    enum { MAX_COLOURS = 64 };
+    ///pairs of colour c are colour_start[c] ... colour_start[c + 1] - 1,
+    ///0: the pairs are not coloured; set by ParticleManager::BuildInteraction()
+    int number_of_colours;
+    int colour_start[MAX_COLOURS + 2];
+
+    ///particle pair
+    int *Org;      ///particel with larger ID
+    int *Dest;     ///particel with smaller ID
 
     ///distance between the two particles, weight and derivatives
-    double rij, rrij, Wij, Fij, LapWij, Wij2;
-    Vec2d eij; ///pair direction from orginal particle to destination particle 
-    double shear_rij, bulk_rij; ///particle length to implement slip boundary
+    double *rij, *Wij, *Fij, *LapWij;
+    Vec2d *eij; ///pair direction from orginal particle to destination particle
+    double *shear_rij, *bulk_rij; ///particle length to implement slip boundary
+    double *random_p, *random_v; ///increments of the Wiener process
 
 #ifdef _OPENMP
     ///temporary storage of computation terms
-    double drhodt1, drhodt2;
-    Vec2d _dU1, _dU2, dUdt1, dUdt2;
+    double *drhodt1, *drhodt2;
+    Vec2d *_dU1, *_dU2, *dUdt1, *dUdt2;
 #endif
-                
-public:
+
     ///constructor
-    Interaction(Initiation &ini);
-    Interaction(Particle *prtl_org, Particle *prtl_dest, Force **forces,
-                QuinticSpline &weight_function, double dstc, Initiation& ini);
-        
-    ///use old interaction object for new interaction
-    void NewInteraction(Particle *prtl_org, Particle *prtl_dest, Force **forces,
-                        QuinticSpline &weight_function, double dstc);
+    Interaction(ParticleStore &particles, Initiation &ini);
+    ///destructor
+    ~Interaction();
+
+    ///start a new pair list
+    void NewList(Force **forces, QuinticSpline &weight_function);
+    ///set the number of pairs, Org and Dest are filled in by the caller
+    ///and the pair values are computed by the sweep Renew
+    void Resize(int n);
 
-    ///renew pair parameters and changing pair values
-    void RenewInteraction(QuinticSpline &weight_function);
+    ///apply a pair summation, or two in order in as few sweeps over the pairs as their data allow;
+    ///the pairs are visited serially or batch by batch in parallel;
+    ///the summations used are instantiated in interaction.cpp
+    template <class PairSummation> void Sweep();
+    template <class First, class Second> void Sweep();
 
     ///pair interaction
-    void SummationDensity();
-    void SummationShearRate();
+    void SummationDensity(int k);
+    void SummationShearRate(int k);
 
     ///pahse field and phase gradient
-    void SummationPhaseField();
-    void SummationCurvature();
-    void SummationPhaseGradient();
-    void SummationPhaseGradient_old();
-    void SummationPhaseLaplacian();
+    void SummationPhaseField(int k);
+    void SummationCurvature(int k);
+    void SummationPhaseGradient(int k);
+    void SummationPhaseGradient_old(int k);
+    void SummationPhaseLaplacian(int k);
 
     ///update forces
-    void UpdateForces();
-    void UpdateForces_vis();
+    void UpdateForces(int k);
+    void UpdateForces_vis(int k);
+#ifdef _OPENMP
+    void SummationUpdateForces(int k);
+#endif
+
+    ///update random forces from the Wiener increments random_p[k] and random_v[k]
+    void RandomForces(int k);
 #ifdef _OPENMP
-    void SummationUpdateForces();
+    void SummationRandomForces(int k);
 #endif
+    void RandomForces_Espanol(int k, Wiener &wiener, double sqrtdt);
+
+    ///symmetric xy virial sum(rij*Fij) of the pair forces between fluid particles 
+    ///with the current pair values, without the random forces; 
+    ///a pair with a periodic ghost counts half
+    double ShearVirial() const;
 
-    ///update random forces
-    void RandomForces(Wiener &wiener, double sqrtdt);
-    void RandomForces_Espanol(Wiener &wiener, double sqrtdt);
-        
 };
 #endif
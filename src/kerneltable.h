@@ -0,0 +1,99 @@
+/// \file kerneltable.h
+/// \brief                                      Tabulated kernel.
+
+#ifndef KERNELTABLE_H
+#define KERNELTABLE_H
+
+/// Kernel values tabulated over the squared distance
+///
+/// KernelType is an analytic kernel with Values(distance, w, F_r, lapW).
+/// The table has the same Values() and can replace the analytic kernel
+/// as template parameter of the pair loops.
+template <class KernelType> class KernelTable
+{
+    ///number of intervals of the table
+    int number_of_intervals;
+    ///1: linear, 3: cubic Hermite interpolation
+    int order;
+    ///support radius and the squared distance covered by one interval
+    double support, ds, rds;
+    ///w, F_r, lapW and their slopes times ds at each node
+    double *values;
+
+public:
+
+    ///tabulate a kernel with the given support radius
+    KernelTable(const KernelType &kernel, const double support, const int number_of_intervals, const int order);
+    ///destructor
+    ~KernelTable() { delete[] values; }
+
+    ///Calculates w, F divided by the distance and LapW at once.
+    void Values(const double distance, double &w, double &F_r, double &lapW) const
+    {
+        // position in the table, the last interval is used beyond the support
+        const double x = distance*distance*rds;
+        int n = int(x);
+        n = n < number_of_intervals ? n : number_of_intervals - 1;
+        const double t = x - n;
+        const double *a = values + 6*n, *b = a + 6;
+
+        if(order == 1) {
+            const double s = 1.0 - t;
+            w = s*a[0] + t*b[0]; F_r = s*a[1] + t*b[1]; lapW = s*a[2] + t*b[2];
+        }
+        else {
+            // cubic Hermite basis functions
+            const double t2 = t*t, t3 = t2*t;
+            const double h00 = 2.0*t3 - 3.0*t2 + 1.0, h10 = t3 - 2.0*t2 + t;
+            const double h01 = - 2.0*t3 + 3.0*t2, h11 = t3 - t2;
+            w = h00*a[0] + h10*a[3] + h01*b[0] + h11*b[3];
+            F_r = h00*a[1] + h10*a[4] + h01*b[1] + h11*b[4];
+            lapW = h00*a[2] + h10*a[5] + h01*b[2] + h11*b[5];
+        }
+        // zero outside of the support
+        if(distance >= support) { w = 0.0; F_r = 0.0; lapW = 0.0; }
+        // no direction for coinciding particles, as in the analytic kernel
+        if(distance == 0.0) F_r = 0.0;
+    }
+};
+
+//----------------------------------------------------------------------------------------
+//                                                      constructor
+//----------------------------------------------------------------------------------------
+template <class KernelType> 
+KernelTable<KernelType>::KernelTable(const KernelType &kernel, const double support, 
+                                     const int number_of_intervals, const int order)
+    : number_of_intervals(number_of_intervals), order(order), support(support)
+{
+    int n, m;
+
+    if(number_of_intervals < 2 || (order != 1 && order != 3)) {
+        std::cout<<"KernelTable: at least 2 intervals and linear (1) or cubic (3) interpolation are needed! \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+
+    ds = support*support/number_of_intervals;
+    rds = 1.0/ds;
+    values = new double[6*(number_of_intervals + 1)];
+
+    // the kernel at the nodes
+    for(n = 0; n <= number_of_intervals; n++) 
+        kernel.Values(sqrt(n*ds), values[6*n], values[6*n + 1], values[6*n + 2]);
+    // F_r at zero distance is the limit from the next nodes
+    values[1] = 2.0*values[7] - values[13];
+
+    // slopes times ds, the harmonic mean of the neighbouring differences keeps 
+    // the interpolation monotone between the nodes, so that it does not undershoot
+    // below zero where the kernel vanishes; one sided at both ends
+    for(n = 0; n <= number_of_intervals; n++) 
+        for(m = 0; m < 3; m++) {
+            const double d0 = n > 0 ? values[6*n + m] - values[6*(n - 1) + m] : 0.0;
+            const double d1 = n < number_of_intervals ? values[6*(n + 1) + m] - values[6*n + m] : 0.0;
+            if(n == 0) values[6*n + 3 + m] = d1;
+            else if(n == number_of_intervals) values[6*n + 3 + m] = d0;
+            else values[6*n + 3 + m] = d0*d1 > 0.0 ? 2.0*d0*d1/(d0 + d1) : 0.0;
+        }
+}
+
+#endif
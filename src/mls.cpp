@@ -21,7 +21,6 @@
 #include "mls.h"
 #include "initiation.h"
 #include "quinticspline.h"
-#include "particle.h"
 
 using namespace std;
 
@@ -101,23 +100,24 @@ void MLS::MLS_Solver(int order)
 //----------------------------------------------------------------------------------------
 //                              set up the enviroment for MLS calculation and run MLS solver
 //----------------------------------------------------------------------------------------
-void MLS::MLSMapping(Vec2d &point, Llist<Particle> &NNP_list, QuinticSpline &weight_function, int order)
+void MLS::MLSMapping(Vec2d &point, ParticleStore &store, int *NNP_list, int NNP_number,
+                     QuinticSpline &weight_function, int order)
 {
     N = 0; //numbers of reference points
     p[0] = 1.0; p[1] = point[0]; p[2] = point[1];
                 
-    //iterate this cell list
-    for (LlistNode<Particle> *pstn = NNP_list.first(); 
-         !NNP_list.isEnd(pstn); 
-         pstn = NNP_list.next(pstn)) {
+    //iterate this NNP list
+    for(int k = 0; k < NNP_number; k++) {
                                 
         //get particle data
-        Particle *prtl = NNP_list.retrieve(pstn);
-        Wi[N] = weight_function.w(v_distance(point, prtl->R));
+        int prtl = NNP_list[k];
+        //the image of the particle next to the point
+        Vec2d position = store.Image(prtl, point);
+        Wi[N] = weight_function.w(v_distance(point, position));
         //assign values
         pi[0][N] = 1.0;
-        pi[1][N] = prtl->R[0];
-        pi[2][N] = prtl->R[1];
+        pi[1][N] = position[0];
+        pi[2][N] = position[1];
         B[0][N] = pi[0][N]*Wi[N];
         B[1][N] = pi[1][N]*Wi[N];
         B[2][N] = pi[2][N]*Wi[N];
@@ -9,7 +9,6 @@
 #define MLS_H
 
 class Initiation;
-class Particle;
 class QuinticSpline;
 
 /// Moving Least Squares Approximation (MLS)
@@ -34,7 +33,8 @@ public:
     ~MLS();
 
     ///MLS Mapping to grid points
-    void MLSMapping(Vec2d &point, Llist<Particle> &NNP_list, QuinticSpline &weight_function, int order);
+    void MLSMapping(Vec2d &point, ParticleStore &store, int *NNP_list, int NNP_number,
+                    QuinticSpline &weight_function, int order);
 
 };
 
@@ -0,0 +1,73 @@
+// movie2dat.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Convert the binary particle movie to text
+//              movie2dat.cpp
+//----------------------------------------------------------------------------------------
+
+#include <iostream>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// ***** localincludes *****
+#include "moviefile.h"
+
+using namespace std;
+
+/// \file movie2dat.cpp
+/// \brief Convert the binary particle movie outdata/prtl_movie.bin to text
+///
+/// movie2dat <movie file> [-t] [-f <frame>]
+///
+/// The frames are written to the standard output as lines of x, y, material and rho,
+/// by default the frames separated by an empty line. These four columns are not the
+/// columns of the particle files collected by scripts/dat2punto.sh. With -t the frames
+/// are written in the Tecplot layout of the text movie, one zone for each frame. With -f only the given frame
+/// is written, the first frame is 0.
+
+int main(int argc, char *argv[]) {
+
+    int tecplot = 0;
+    long long frame = -1, k;
+    int i;
+
+    if(argc < 2) {
+        cout<<"Usage: movie2dat <movie file> [-t] [-f <frame>]\n";
+        exit(1);
+    }
+    for(i = 2; i < argc; i++) {
+        if(!strcmp(argv[i], "-t")) tecplot = 1;
+        else if(!strcmp(argv[i], "-f") && i + 1 < argc) frame = atoll(argv[++i]);
+        else {
+            cout<<"movie2dat: unknown option "<<argv[i]<<"\n";
+            exit(1);
+        }
+    }
+
+    MovieReader movie;
+    if(!movie.Open(argv[1])) {
+        cout<<"movie2dat: "<<argv[1]<<" is not a binary particle movie\n";
+        exit(1);
+    }
+
+    if(tecplot) {
+        printf("title='particle movie' \n");
+        printf("variables=x, y, material, size \n");
+    }
+
+    const long long first = frame < 0 ? 0 : frame;
+    const long long last = frame < 0 ? movie.number_of_frames - 1 : frame;
+    for(k = first; k <= last; k++) {
+        movie.ReadFrame(k);
+        if(tecplot) printf("zone t='%g' \n", movie.Time);
+        for(i = 0; i < movie.number_of_particles; i++)
+            printf("%g %g %d %g\n", movie.x[i], movie.y[i], movie.material[i], movie.rho[i]);
+        if(!tecplot) printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,382 @@
+// moviefile.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Binary particle movie file
+//              moviefile.cpp
+//----------------------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+
+#include <cstdlib>
+#include <cstring>
+
+// ***** localincludes *****
+#include "moviefile.h"
+#include "restartfile.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                      position x quantized to 16 bits in a box of the length l
+//----------------------------------------------------------------------------------------
+static unsigned short Quantize(double x, double l)
+{
+    const int q = int(x/l*65536.0);
+    return q < 0 ? 0 : (q > 65535 ? 65535 : q);
+}
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+MovieWriter::MovieWriter():
+compression(0), keyframe(1), number_of_frames(0), index_capacity(0), index(0), index_offset(0),
+number_of_particles(0), capacity(0), qx(0), qy(0), buffer_capacity(0), buffer(0)
+{
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+MovieWriter::~MovieWriter()
+{
+    Close();
+    delete[] index; delete[] qx; delete[] qy; delete[] buffer;
+}
+//----------------------------------------------------------------------------------------
+//              create the movie file with the material names and the box of the positions
+//----------------------------------------------------------------------------------------
+void MovieWriter::Create(const char *file_name, int number_of_materials, const char *const *material_names,
+                         const double *box_size, int compression)
+{
+    if(!RestartByteOrder()) {
+        cout<<"MovieWriter: the binary movie needs a little-endian machine \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+
+    this->compression = compression;
+    keyframe = compression ? MOVIE_KEYFRAME : 1;
+    this->box_size[0] = box_size[0]; this->box_size[1] = box_size[1];
+    number_of_frames = 0;
+    number_of_particles = 0;
+
+    MovieHeader header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, MOVIE_MAGIC);
+    header.version = MOVIE_VERSION;
+    header.number_of_materials = number_of_materials;
+    header.box_size[0] = box_size[0]; header.box_size[1] = box_size[1];
+    header.compression = compression;
+    header.keyframe = keyframe;
+
+    if(file.is_open()) file.close();
+    file.open(file_name, ios::in | ios::out | ios::binary | ios::trunc);
+    if(!file) {
+        cout<<"MovieWriter: Cannot create "<< file_name <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    file.write((const char *)&header, sizeof(header));
+    for(int k = 0; k < number_of_materials; k++) {
+        char name[MOVIE_NAME_LENGTH];
+        memset(name, 0, MOVIE_NAME_LENGTH);
+        strncpy(name, material_names[k], MOVIE_NAME_LENGTH - 1);
+        file.write(name, MOVIE_NAME_LENGTH);
+    }
+    index_offset = file.tellp();
+    file.flush();
+}
+//----------------------------------------------------------------------------------------
+//                              append a frame of n particles
+//----------------------------------------------------------------------------------------
+void MovieWriter::WriteFrame(double Time, int n, const double *R, const int *material, const double *rho)
+{
+    int i;
+
+    //a key frame after keyframe frames and if the number of particles changes
+    MovieFrameHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Time = Time;
+    header.number_of_particles = n;
+    header.key = number_of_frames % keyframe == 0 || n != number_of_particles;
+
+    if(n > capacity) {
+        delete[] qx; delete[] qy; delete[] buffer;
+        capacity = n;
+        qx = new unsigned short[capacity]; qy = new unsigned short[capacity];
+        //the largest frame: 3 bytes for each difference
+        buffer_capacity = 11*(long long)capacity;
+        buffer = new char[buffer_capacity];
+    }
+
+    //density and material
+    char *data = buffer;
+    for(i = 0; i < n; i++) {
+        const float r = float(rho[i]);
+        memcpy(data, &r, sizeof(float)); data += sizeof(float);
+    }
+    for(i = 0; i < n; i++) *data++ = (char)material[i];
+
+    //positions
+    for(int d = 0; d < 2; d++) {
+        unsigned short *q = d == 0 ? qx : qy;
+        for(i = 0; i < n; i++) {
+            const unsigned short qi = Quantize(R[2*i + d], box_size[d]);
+            if(header.key) {
+                memcpy(data, &qi, sizeof(unsigned short)); data += sizeof(unsigned short);
+            } else {
+                //zigzag varint of the difference to the frame before
+                const int dq = int(qi) - int(q[i]);
+                unsigned int z = (unsigned int)((dq << 1) ^ (dq >> 31));
+                while(z >= 0x80) { *data++ = char(z | 0x80); z >>= 7; }
+                *data++ = char(z);
+            }
+            q[i] = qi;
+        }
+    }
+    header.size = data - buffer;
+    number_of_particles = n;
+
+    //the frame is appended after the frames before, the index is written by Close()
+    if(number_of_frames == index_capacity) {
+        index_capacity = index_capacity == 0 ? 64 : 2*index_capacity;
+        MovieIndexEntry *larger = new MovieIndexEntry[index_capacity];
+        if(number_of_frames > 0) memcpy(larger, index, number_of_frames*sizeof(MovieIndexEntry));
+        delete[] index;
+        index = larger;
+    }
+    index[number_of_frames].Time = Time;
+    index[number_of_frames].offset = index_offset;
+    number_of_frames++;
+
+    file.write((const char *)&header, sizeof(header));
+    file.write(buffer, header.size);
+    index_offset = file.tellp();
+    file.flush();
+    if(!file) {
+        cout<<"MovieWriter: Cannot write the movie file \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+}
+//----------------------------------------------------------------------------------------
+//                      write the frame index and the trailer and close the file
+//----------------------------------------------------------------------------------------
+void MovieWriter::Close()
+{
+    if(!file.is_open()) return;
+    WriteIndex();
+    file.close();
+}
+//----------------------------------------------------------------------------------------
+//                      write the frame index and the trailer after the frames
+//----------------------------------------------------------------------------------------
+void MovieWriter::WriteIndex()
+{
+    MovieTrailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    trailer.index_offset = index_offset;
+    trailer.number_of_frames = number_of_frames;
+    strcpy(trailer.magic, MOVIE_MAGIC);
+
+    if(number_of_frames > 0) file.write((const char *)index, number_of_frames*sizeof(MovieIndexEntry));
+    file.write((const char *)&trailer, sizeof(trailer));
+    file.flush();
+    if(!file) {
+        cout<<"MovieWriter: Cannot write the movie file \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+}
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+MovieReader::MovieReader():
+compression(0), qx(0), qy(0), capacity(0), buffer_capacity(0), buffer(0), current(-1),
+number_of_materials(0), material_names(0), number_of_frames(0), index(0),
+Time(0.0), number_of_particles(0), x(0), y(0), rho(0), material(0)
+{
+    box_size[0] = box_size[1] = 0.0;
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+MovieReader::~MovieReader()
+{
+    delete[] qx; delete[] qy; delete[] buffer;
+    delete[] material_names; delete[] index;
+    delete[] x; delete[] y; delete[] rho; delete[] material;
+}
+//----------------------------------------------------------------------------------------
+//                      open a movie file, false if it is not a binary movie
+//----------------------------------------------------------------------------------------
+bool MovieReader::Open(const char *file_name)
+{
+    file.open(file_name, ios::in | ios::binary);
+    if(!file) return false;
+
+    MovieHeader header;
+    MovieTrailer trailer;
+    file.read((char *)&header, sizeof(header));
+    if(!file || strncmp(header.magic, MOVIE_MAGIC, sizeof(header.magic)) != 0) return false;
+    if(header.version != MOVIE_VERSION || !RestartByteOrder()) {
+        cout<<"MovieReader: "<< file_name <<" is not a binary movie of version "<<MOVIE_VERSION
+            <<" for this machine \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    compression = header.compression;
+    box_size[0] = header.box_size[0]; box_size[1] = header.box_size[1];
+    number_of_materials = header.number_of_materials;
+    material_names = new char[number_of_materials][MOVIE_NAME_LENGTH];
+    file.read((char *)material_names, number_of_materials*MOVIE_NAME_LENGTH);
+
+    const long long first_offset = file.tellg();
+
+    //the frame index from the trailer
+    file.seekg(0, ios::end);
+    const long long end = file.tellg();
+    if(end < first_offset + (long long)sizeof(trailer)) trailer.magic[0] = 0;
+    else {
+        file.seekg(end - (long long)sizeof(trailer));
+        file.read((char *)&trailer, sizeof(trailer));
+    }
+    if(!file || strncmp(trailer.magic, MOVIE_MAGIC, sizeof(trailer.magic)) != 0) {
+        file.clear();
+        FindFrames(first_offset, end);
+        current = -1;
+        return true;
+    }
+    number_of_frames = trailer.number_of_frames;
+    index = new MovieIndexEntry[number_of_frames + 1];
+    file.seekg(trailer.index_offset);
+    file.read((char *)index, number_of_frames*sizeof(MovieIndexEntry));
+    if(!file) {
+        cout<<"MovieReader: Cannot read the frame index of "<< file_name <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    current = -1;
+    return true;
+}
+//----------------------------------------------------------------------------------------
+//              the frame index of a movie without trailer, from a running or crashed
+//              simulation: the frames are found from header to header up to the last
+//              complete frame, each header gives the size of the data after it
+//----------------------------------------------------------------------------------------
+void MovieReader::FindFrames(long long offset, long long end)
+{
+    long long index_capacity = 64;
+    index = new MovieIndexEntry[index_capacity];
+    number_of_frames = 0;
+
+    MovieFrameHeader header;
+    while(offset + (long long)sizeof(header) <= end) {
+        file.seekg(offset);
+        file.read((char *)&header, sizeof(header));
+        if(!file || header.number_of_particles < 0 || (header.key != 0 && header.key != 1)
+           || header.size < 0 || header.size > end - offset - (long long)sizeof(header)) break;
+
+        if(number_of_frames == index_capacity) {
+            index_capacity *= 2;
+            MovieIndexEntry *larger = new MovieIndexEntry[index_capacity];
+            memcpy(larger, index, number_of_frames*sizeof(MovieIndexEntry));
+            delete[] index;
+            index = larger;
+        }
+        index[number_of_frames].Time = header.Time;
+        index[number_of_frames].offset = offset;
+        number_of_frames++;
+        offset += sizeof(header) + header.size;
+    }
+    file.clear();
+}
+//----------------------------------------------------------------------------------------
+//                                      read frame k
+//      a frame which is not a key frame is decoded from the key frame before it,
+//      or from the frame read last if it is the frame before
+//----------------------------------------------------------------------------------------
+void MovieReader::ReadFrame(long long k)
+{
+    if(k < 0 || k >= number_of_frames) {
+        cout<<"MovieReader: there is no frame "<< k <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    if(k == current) return;
+
+    long long first = k;
+    while(current < 0 || first != current + 1) {
+        MovieFrameHeader header;
+        file.seekg(index[first].offset);
+        file.read((char *)&header, sizeof(header));
+        if(header.key) break;
+        first--;
+    }
+    for(long long j = first; j <= k; j++) DecodeFrame(j);
+}
+//----------------------------------------------------------------------------------------
+//              decode frame k from the positions of the frame before, if it is not a key frame
+//----------------------------------------------------------------------------------------
+void MovieReader::DecodeFrame(long long k)
+{
+    int i;
+    MovieFrameHeader header;
+    file.seekg(index[k].offset);
+    file.read((char *)&header, sizeof(header));
+
+    const int n = header.number_of_particles;
+    if(n > capacity) {
+        delete[] qx; delete[] qy;
+        delete[] x; delete[] y; delete[] rho; delete[] material;
+        capacity = n;
+        qx = new unsigned short[capacity]; qy = new unsigned short[capacity];
+        x = new double[capacity]; y = new double[capacity];
+        rho = new double[capacity]; material = new int[capacity];
+    }
+    if(header.size > buffer_capacity) {
+        delete[] buffer;
+        buffer_capacity = header.size;
+        buffer = new char[buffer_capacity];
+    }
+    file.read(buffer, header.size);
+    if(!file || (!header.key && n != number_of_particles)) {
+        cout<<"MovieReader: Cannot read frame "<< k <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+
+    //density and material
+    const char *data = buffer;
+    for(i = 0; i < n; i++) {
+        float r;
+        memcpy(&r, data, sizeof(float)); data += sizeof(float);
+        rho[i] = r;
+    }
+    for(i = 0; i < n; i++) material[i] = (unsigned char)*data++;
+
+    //positions
+    for(int d = 0; d < 2; d++) {
+        unsigned short *q = d == 0 ? qx : qy;
+        double *pstn = d == 0 ? x : y;
+        for(i = 0; i < n; i++) {
+            if(header.key) {
+                memcpy(&q[i], data, sizeof(unsigned short)); data += sizeof(unsigned short);
+            } else {
+                unsigned int z = 0;
+                int shift = 0;
+                while(*data & 0x80) { z |= (unsigned int)(*data++ & 0x7f) << shift; shift += 7; }
+                z |= (unsigned int)(*data++) << shift;
+                const int dq = int(z >> 1) ^ -int(z & 1);
+                q[i] = (unsigned short)(q[i] + dq);
+            }
+            //the center of the quantization interval
+            pstn[i] = (q[i] + 0.5)*box_size[d]/65536.0;
+        }
+    }
+
+    Time = header.Time;
+    number_of_particles = n;
+    current = k;
+}
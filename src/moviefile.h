@@ -0,0 +1,146 @@
+/// \file moviefile.h
+/// \brief Binary particle movie file
+
+#ifndef MOVIEFILE_H
+#define MOVIEFILE_H
+
+#include <fstream>
+
+/// Binary particle movie
+///
+/// The file is the header, the material table, the frames, the frame index and the
+/// trailer, all little-endian. The trailer at the end of the file gives the position
+/// of the frame index, which gives the time and the position of each frame, so a
+/// frame is found without reading the frames before it.
+/// A frame is a MovieFrameHeader and the data of its particles:
+/// rho (float), the material number (1 byte) and the positions quantized to 16 bits
+/// relative to the box size. Without compression the positions are x[n] and y[n]
+/// (16 bit unsigned). With compression the key frames are stored the same way and
+/// the other frames store the differences to the positions of the frame before as
+/// zigzag varints, one byte for a particle moving less than 1/1024 of the box.
+/// The frames are appended and flushed one by one, the index and the trailer are
+/// written when the movie is closed. The file of a running or crashed simulation has
+/// no trailer, its frames are found from header to header up to the last complete frame.
+struct MovieHeader {
+    char magic[8];              ///MOVIE_MAGIC
+    int version;                ///MOVIE_VERSION
+    int number_of_materials;    ///entries of the material table
+    double box_size[2];         ///box of the quantized positions
+    int compression;            ///0: none, 1: differences to the frame before
+    int keyframe;               ///at most every keyframe-th frame is a key frame
+};
+
+///header of a frame
+struct MovieFrameHeader {
+    double Time;                ///time of the frame
+    int number_of_particles;    ///number of particles of the frame
+    int key;                    ///1: a key frame, 0: differences to the frame before
+    long long size;             ///bytes of the particle data after the header
+};
+
+///entry of the frame index
+struct MovieIndexEntry {
+    double Time;                ///time of the frame
+    long long offset;           ///position of the frame header in the file
+};
+
+///end of the file
+struct MovieTrailer {
+    long long index_offset;     ///position of the frame index
+    long long number_of_frames; ///entries of the frame index
+    char magic[8];              ///MOVIE_MAGIC
+};
+
+#define MOVIE_MAGIC "SPH-MOV"
+enum { MOVIE_VERSION = 1, MOVIE_NAME_LENGTH = 32, MOVIE_KEYFRAME = 16 };
+
+/// Writing a binary particle movie
+class MovieWriter {
+
+    std::fstream file;
+    int compression, keyframe;
+    double box_size[2];
+
+    ///the frame index
+    long long number_of_frames, index_capacity;
+    MovieIndexEntry *index;
+    ///position after the frames, the frame index is written there
+    long long index_offset;
+
+    ///quantized positions of the frame before
+    int number_of_particles, capacity;
+    unsigned short *qx, *qy;
+    ///data of a frame
+    long long buffer_capacity;
+    char *buffer;
+
+    ///write the frame index and the trailer after the frames
+    void WriteIndex();
+
+public:
+
+    ///constructor
+    MovieWriter();
+    ///destructor
+    ~MovieWriter();
+
+    ///create the movie file with the material names and the box of the positions,
+    ///compression 0: none, 1: differences to the frame before
+    void Create(const char *file_name, int number_of_materials, const char *const *material_names,
+                const double *box_size, int compression);
+    ///append a frame of n particles, the positions R are the x and y of each particle
+    void WriteFrame(double Time, int n, const double *R, const int *material, const double *rho);
+    ///write the frame index and the trailer and close the file, called by the destructor
+    void Close();
+};
+
+/// Reading a binary particle movie
+class MovieReader {
+
+    std::ifstream file;
+    int compression;
+
+    ///quantized positions of the frame read last
+    unsigned short *qx, *qy;
+    ///length of the particle arrays
+    int capacity;
+    ///data of a frame
+    long long buffer_capacity;
+    char *buffer;
+    ///number of the frame read last, -1: none
+    long long current;
+
+    ///decode frame k from the positions of the frame before, if it is not a key frame
+    void DecodeFrame(long long k);
+    ///the frame index of a movie without trailer, from the frame headers between offset and end
+    void FindFrames(long long offset, long long end);
+
+public:
+
+    ///materials of the movie
+    int number_of_materials;
+    char (*material_names)[MOVIE_NAME_LENGTH];
+    ///box of the positions
+    double box_size[2];
+    ///the frame index
+    long long number_of_frames;
+    MovieIndexEntry *index;
+
+    ///the frame read last
+    double Time;
+    int number_of_particles;
+    double *x, *y, *rho;
+    int *material;
+
+    ///constructor
+    MovieReader();
+    ///destructor
+    ~MovieReader();
+
+    ///open a movie file, false if it is not a binary movie
+    bool Open(const char *file_name);
+    ///read frame k into Time, number_of_particles, x, y, rho and material
+    void ReadFrame(long long k);
+};
+
+#endif
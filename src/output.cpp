@@ -14,11 +14,14 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 // ***** localincludes *****
 #include "glbcls.h"
 #include "glbfunc.h"
 #include "output.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
 #include "boundary.h"
 #include "particlemanager.h"
@@ -26,7 +29,10 @@
 #include "initiation.h"
 #include "quinticspline.h"
 #include "material.h"
-#include "particle.h"
+#include "restartfile.h"
+#include "outputwriter.h"
+#include "moviefile.h"
+#include "gridmapping.h"
 
 using namespace std;
 
@@ -41,6 +47,24 @@ Output::Output(Initiation &ini)
     x_cells = ini.x_cells; y_cells = ini.y_cells;
     hdelta = ini.hdelta; 
     delta = ini.delta;
+    restart_format = ini.restart_format;
+    movie_format = ini.movie_format; movie_compression = ini.movie_compression;
+    box_size = ini.box_size;
+    movie = new MovieWriter;
+    //the states on the output grid
+    grid = new GridMapping(ini);
+
+    //the thread writing the particle files
+    writer = new OutputWriter(*this, number_of_materials, ini.async_output);
+}
+//--------------------------------------------------------------------------------------------
+//                                      destructor, writes the remaining output
+//--------------------------------------------------------------------------------------------
+Output::~Output()
+{
+    delete writer;
+    delete movie;
+    delete grid;
 }
 //--------------------------------------------------------------------------------------------
 //                              output particle positions respected different materials
@@ -48,14 +72,21 @@ Output::Output(Initiation &ini)
 void Output::OutputParticles(Hydrodynamics &hydro, Boundary &boundary, 
                              double Time, Initiation &ini)
 {
-    int i, j;
-    double Itime;
-    char file_name[150], file_list[120];
-	std::cerr << "Output::OutputParticles is called" << std::endl;
+	std::cerr << "Output::OutputParticles is called" << std::endl;
 	std::cerr << "Time of the output is " << Time << std::endl;
  hydro.setTime(Time);
+    writer->Stage(hydro, Time).jobs |= OUTPUT_PARTICLES;
+}
+//--------------------------------------------------------------------------------------------
+//                              write the particle positions from a snapshot
+//--------------------------------------------------------------------------------------------
+void Output::WriteParticles(const OutputFrame &frame)
+{
+    int i, j;
+    double Itime;
+    char file_name[150], file_list[120];
     //produce output file name
-    Itime = Time*1.0e6;
+    Itime = frame.Time*1.0e6;
     strcpy(file_name,"./outdata/prtl");
     sprintf(file_list, "%.10d", (int)Itime);
     strcat(file_name, file_list);
@@ -70,44 +101,22 @@ void Output::OutputParticles(Hydrodynamics &hydro, Boundary &boundary,
     for(i = 0; i < number_of_materials; i++) {
                 
         j = 0; //if there is such material or not
-        //iterate the real partilce list
-        for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-             !hydro.particle_list.isEnd(p); 
-             p = hydro.particle_list.next(p)) {
+        //iterate the real partilces
+        for(int prtl = 0; prtl < frame.number_of_real; prtl++) {
                                 
-            Particle *prtl = hydro.particle_list.retrieve(p);
-            if(strcmp(hydro.materials[i].material_name, prtl->mtl->material_name) == 0) {
+            if(frame.material[prtl] == i) {
                 j ++;
-                if(j == 1)      out<<"t='"<<hydro.materials[i].material_name<<"' \n";
-				    out<<prtl->R[0]<<"  "<<prtl->R[1]
-                  <<"  "<<prtl->U[0]<<"  "<<prtl->U[1]<<"  "<<
-				  prtl->dUdt[0]<<"  "<<prtl->dUdt[1]<<"  "<<
-                                        prtl->_dU[0]<<"  "<<prtl->_dU[1]<<" "<<prtl->rho<<"\n";
-                //out<<ini.dms_length(prtl->R[0])<<"  "<<ini.dms_length(prtl->R[1])
-                  // <<"  "<<ini.dms_velocity(prtl->U[0])<<"  "<<ini.dms_velocity(prtl->U[1])<<
-					//"  "<<prtl->dUdt[0]<<"  "<<prtl->dUdt[1]<<"  "<<
-					//prtl->_dU[0]<<"  "<<prtl->_dU[1]<<"  "<<prtl->rho<<" "<<prtl->ID<<" "<<prtl->polyID<<"\n";
-				//out<<ini.dms_length(prtl->R[0])<<"  "<<ini.dms_length(prtl->R[1])
-                  // <<"  "<<ini.dms_velocity(prtl->U[0])<<"  "<<ini.dms_velocity(prtl->U[1])<<
-					//"  "<<prtl->dUdt[0]<<"  "<<prtl->dUdt[1]<<"  "<<"1"<<"\n";
+                if(j == 1)      out<<"t='"<<frame.materials[i].material_name<<"' \n";
+				    out<<frame.R[prtl][0]<<"  "<<frame.R[prtl][1]
+                  <<"  "<<frame.U[prtl][0]<<"  "<<frame.U[prtl][1]<<"  "<<
+				  frame.dUdt[prtl][0]<<"  "<<frame.dUdt[prtl][1]<<"  "<<
+                                        frame._dU[prtl][0]<<"  "<<frame._dU[prtl][1]<<" "<<frame.rho[prtl]<<"\n";
             }
         }
 
-        //iterate the boundary partilce list
-        for (LlistNode<Particle> *p1 = boundary.boundary_particle_list.first(); 
-             !boundary.boundary_particle_list.isEnd(p1); 
-             p1 = boundary.boundary_particle_list.next(p1)) {
-                                
-            Particle *prtl = boundary.boundary_particle_list.retrieve(p1);
-            if(strcmp(hydro.materials[i].material_name, prtl->mtl->material_name) == 0) { 
-                j ++;
-                if(j == 1)      out<<"zone t='"<<hydro.materials[i].material_name<<"' \n";
-               // out<<prtl->R[0]<<"  "<<prtl->R[1]<<"  "<<prtl->U[0]<<"  "<<prtl->U[1]<<"  "<<prtl->dUdt[0]<<"  "<<prtl->dUdt[1]<<"  "<<prtl->rho<<" "<<"\n";
-                  //out<<ini.dms_length(prtl->R[0])<<"  "<<ini.dms_length(prtl->R[1])
-                   //<<"  "<<ini.dms_velocity(prtl->U[0])<<"  "<<ini.dms_velocity(prtl->U[1])<<
-					//"  "<<prtl->dUdt[0]<<"  "<<prtl->dUdt[1]<<"  "<<"0"<<"\n";
-            }
-        }
+        //the boundary partilces are not written, only the zone of their material
+        if(j == 0 && frame.boundary_material[i]) 
+            out<<"zone t='"<<frame.materials[i].material_name<<"' \n";
     }
 
 }
@@ -117,16 +126,13 @@ void Output::OutputParticles(Hydrodynamics &hydro, Boundary &boundary,
 void Output::OutputStates(ParticleManager &particles, MLS &mls, QuinticSpline &weight_function, 
                           double Time, Initiation &ini)
 {
-    int i, j, n;
-    int gridx, gridy;
-    Vec2d pstn;
-    double rho, phi, pressure, Temperature, x_velocity, y_velocity;
+    int i, j;
     double Itime;
     char file_name[150], file_list[110];
 
-        
-    //grid box size
-    gridx = x_cells*hdelta; gridy = y_cells*hdelta;
+    //map the particle states to the grid
+    grid->Map(particles, weight_function, 1);
+    const int gridx = grid->GridX(), gridy = grid->GridY();
         
     //produce output file name
     Itime = Time*1.0e6;
@@ -145,40 +151,12 @@ void Output::OutputStates(ParticleManager &particles, MLS &mls, QuinticSpline &w
     //NOTE: loop the x direction first and then the y direction!
     for(j = 0; j <= gridy; j++) { 
         for(i = 0; i <= gridx; i++) {
-            pstn[0] = i*delta; pstn[1] = j*delta;
-            //biuld the NNP_list
-            particles.BuildNNP(pstn);
-            //if the NNP list is not empty run MLS approximation
-            if(!particles.NNP_list.empty()) 
-                mls.MLSMapping(pstn, particles.NNP_list, weight_function, 1);
-            n = 0;
-            rho = 0.0; phi = 0.0; pressure = 0.0; Temperature = 0.0;
-            x_velocity = 0.0; y_velocity = 0.0;
-            //iterate this Nearest Neighbor Particle list
-            for (LlistNode<Particle> *p = particles.NNP_list.first(); 
-                 !particles.NNP_list.isEnd(p); 
-                 p = particles.NNP_list.next(p)) {
-                        
-                //get particle data
-                Particle *prtl = particles.NNP_list.retrieve(p);
-
-                rho += prtl->rho*mls.phi[n];
-                phi += prtl->phi[2][2]*mls.phi[n];
-                pressure += prtl->p*mls.phi[n];
-                Temperature += prtl->T*mls.phi[n];
-                x_velocity += prtl->U[0]*mls.phi[n];
-                y_velocity += prtl->U[1]*mls.phi[n];
-                                
-                n ++;
-            }
-            //clear the NNP_list
-            particles.NNP_list.clear();
-
-            out<<pstn[0]<<"  "<<pstn[1]
-               <<"  "<<pressure<<"  "<<rho
-               <<"  "<<phi
-               <<"  "<<x_velocity<<"  "<<y_velocity
-               <<"  "<<Temperature<<"\n";
+            const double *state = grid->State(i, j);
+            out<<i*delta<<"  "<<j*delta
+               <<"  "<<state[GRID_P]<<"  "<<state[GRID_RHO]
+               <<"  "<<state[GRID_PHI]
+               <<"  "<<state[GRID_UX]<<"  "<<state[GRID_UY]
+               <<"  "<<state[GRID_T]<<"\n";
         }
     }
     out.close();
@@ -188,47 +166,130 @@ void Output::OutputStates(ParticleManager &particles, MLS &mls, QuinticSpline &w
 //              Output real particle data for restart the computation
 //--------------------------------------------------------------------------------------------
 void Output::OutRestart(Hydrodynamics &hydro, double Time, Initiation &ini)
+{
+    writer->Stage(hydro, Time).jobs |= OUTPUT_RESTART;
+}
+//--------------------------------------------------------------------------------------------
+//                              write the restart file from a snapshot
+//--------------------------------------------------------------------------------------------
+void Output::WriteRestart(const OutputFrame &frame)
 {
     int n;
-    char outputfile[150];
+    char outputfile[150], tempfile[160];
 
     //non-dimensional data
     strcpy(outputfile, Project_name);
     strcat(outputfile,".rst");
-    ofstream out(outputfile);
+    //the file is written under a temporary name and renamed when it is complete,
+    //so a crash never leaves a broken restart file
+    strcpy(tempfile, outputfile);
+    strcat(tempfile, ".tmp");
 
     //calculate the real particle number
     n = 0;
-    for (LlistNode<Particle> *pp = hydro.particle_list.first(); 
-         !hydro.particle_list.isEnd(pp); 
-         pp = hydro.particle_list.next(pp)) {
-                        
-        Particle *prtl = hydro.particle_list.retrieve(pp);
-        if(prtl->bd == 0) n ++;
-                                                
-    }
-    //out reinitiation Time
-    out<<Time<<"\n";
-    out<<n<<"\n";
-    //output real particles
-    //iterate the partilce list
-    for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-         !hydro.particle_list.isEnd(p); 
-         p = hydro.particle_list.next(p)) {
+    for(int prtl = 0; prtl < frame.number_of_real; prtl++)
+        if(frame.bd[prtl] == 0) n ++;
+
+    if(restart_format == 0) {
+        ofstream out(tempfile);
+        //out reinitiation Time
+        out<<frame.Time<<"\n";
+        out<<n<<"\n";
+        //output real particles
+        //iterate the partilces
+        for(int prtl = 0; prtl < frame.number_of_real; prtl++) {
                                 
-        Particle *prtl = hydro.particle_list.retrieve(p);
-        if(prtl->bd == 0) 
-            out<<prtl->mtl->material_name<<"  "<<prtl->R[0]<<"  "<<prtl->R[1]<<"  "<<prtl->U[0]<<"  "<<prtl->U[1]
-               <<"  "<<prtl->rho<<"  "<<prtl->p<<"  "<<prtl->T<<"  \n";
+            if(frame.bd[prtl] == 0) 
+                out<<frame.materials[frame.material[prtl]].material_name<<"  "<<frame.R[prtl][0]<<"  "<<frame.R[prtl][1]
+                   <<"  "<<frame.U[prtl][0]<<"  "<<frame.U[prtl][1]
+                   <<"  "<<frame.rho[prtl]<<"  "<<frame.p[prtl]<<"  "<<frame.T[prtl]<<"  \n";
+        }
+        out.close();
+    }
+    else OutBinaryRestart(frame, n, tempfile);
+
+    if(rename(tempfile, outputfile) != 0) {
+        cout<<"Output: Cannot write the restart file "<< outputfile <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
     }
+}
+//--------------------------------------------------------------------------------------------
+//                      Output the n real particles for restart in the binary format
+//--------------------------------------------------------------------------------------------
+void Output::OutBinaryRestart(const OutputFrame &frame, int n, const char *outputfile)
+{
+    int k, prtl;
+    const RestartLayout layout(number_of_materials, n);
+
+    if(!RestartByteOrder()) {
+        cout<<"Output: the binary restart file needs a little-endian machine \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+
+    //header and material table
+    RestartHeader header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, RESTART_MAGIC);
+    header.version = RESTART_VERSION;
+    header.number_of_materials = number_of_materials;
+    header.number_of_particles = n;
+    header.time = frame.Time;
+    header.random_step = frame.random_step;
+    header.random_seed = frame.random_seed;
+    char *table = new char[layout.R - layout.materials];
+    memset(table, 0, layout.R - layout.materials);
+    for(k = 0; k < number_of_materials; k++) 
+        strncpy(table + k*RESTART_NAME_LENGTH, frame.materials[k].material_name, RESTART_NAME_LENGTH - 1);
+
+    //the fields of the real particles, one array after the other
+    char *data = new char[layout.size - layout.R];
+    Vec2d *R = (Vec2d *)data, *U = (Vec2d *)(data + (layout.U - layout.R));
+    double *rho = (double *)(data + (layout.rho - layout.R)), *p = (double *)(data + (layout.p - layout.R));
+    double *T = (double *)(data + (layout.T - layout.R));
+    long long *polyID = (long long *)(data + (layout.polyID - layout.R));
+    long long *ID = (long long *)(data + (layout.ID - layout.R));
+    int *material = (int *)(data + (layout.material - layout.R));
+    for(prtl = 0, k = 0; prtl < frame.number_of_real; prtl++) 
+        if(frame.bd[prtl] == 0) {
+            R[k] = frame.R[prtl]; U[k] = frame.U[prtl];
+            rho[k] = frame.rho[prtl]; p[k] = frame.p[prtl]; T[k] = frame.T[prtl];
+            polyID[k] = frame.polyID[prtl]; ID[k] = frame.ID[prtl];
+            material[k] = frame.material[prtl];
+            k++;
+        }
+
+    ofstream out(outputfile, ios::out | ios::binary);
+    out.write((const char *)&header, sizeof(header));
+    out.write(table, layout.R - layout.materials);
+    out.write(data, layout.size - layout.R);
     out.close();
+    delete[] table; delete[] data;
+
+    if(!out) {
+        cout<<"Output: Cannot write the restart file "<< outputfile <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
 }
 //--------------------------------------------------------------------------------------------
 //                                      creat a head file for a movie of particle motion
 //--------------------------------------------------------------------------------------------
-void Output::CreatParticleMovie()
+void Output::CreatParticleMovie(Hydrodynamics &hydro)
 {
     char file_name[150];
+
+    //the binary movie with the material names and the box of the positions
+    if(movie_format == 1) {
+        const char **material_names = new const char *[number_of_materials];
+        for(int k = 0; k < number_of_materials; k++) material_names[k] = hydro.materials[k].material_name;
+        const double box[2] = {box_size[0], box_size[1]};
+        movie->Create("./outdata/prtl_movie.bin", number_of_materials, material_names, box, movie_compression);
+        delete[] material_names;
+        return;
+    }
+
     //produce output file name
     strcpy(file_name,"./outdata/prtl_movie.dat");
 
@@ -245,48 +306,64 @@ void Output::CreatParticleMovie()
 //--------------------------------------------------------------------------------------------
 void Output::WriteParticleMovie(Hydrodynamics &hydro, double Time, Initiation &ini)
 {
-    int k, m;
+    writer->Stage(hydro, Time).jobs |= OUTPUT_MOVIE;
+}
+//--------------------------------------------------------------------------------------------
+//                              write a frame of the particle movie from a snapshot
+//--------------------------------------------------------------------------------------------
+void Output::WriteMovie(const OutputFrame &frame)
+{
     char file_name[150];
 
+    if(movie_format == 1) {
+        movie->WriteFrame(frame.Time, frame.number_of_real, (const double *)frame.R, frame.material, frame.rho);
+        return;
+    }
+
     //produce output file name
     strcpy(file_name,"./outdata/prtl_movie.dat");
 
-    ofstream out(file_name, ios::out | ios::ate);
+    ofstream out(file_name, ios::out | ios::app);
     //zone names
-    out<<"zone t='"<<Time<<"' \n";
-    //iterate the partilce list
-    for (LlistNode<Particle> *p = hydro.particle_list.first(); 
-         !hydro.particle_list.isEnd(p); 
-         p = hydro.particle_list.next(p)) {
-                        
-        Particle *prtl = hydro.particle_list.retrieve(p);
-        m = -1;
-        //find the number of the material
-        for(k = 0;  k < number_of_materials; k++) 
-            if(strcmp(prtl->mtl->material_name, hydro.materials[k].material_name) == 0) m = k;
-        out<<prtl->R[0]<<"  "<<prtl->R[1]
-           <<"  "<<m<<"  "<<prtl->rho<<"\n";
-    }
+    out<<"zone t='"<<frame.Time<<"' \n";
+
+    //iterate the real and wall partilces
+    for(int prtl = 0; prtl < frame.number_of_real; prtl++) 
+        out<<frame.R[prtl][0]<<"  "<<frame.R[prtl][1]
+           <<"  "<<frame.material[prtl]<<"  "<<frame.rho[prtl]<<"\n";
     out.close();
 
 }
 //--------------------------------------------------------------------------------------------
+//                              write the output files collected in a frame
+//--------------------------------------------------------------------------------------------
+void Output::WriteFrame(const OutputFrame &frame)
+{
+    if(frame.jobs & OUTPUT_PARTICLES) WriteParticles(frame);
+    if(frame.jobs & OUTPUT_MOVIE) WriteMovie(frame);
+    if(frame.jobs & OUTPUT_RESTART) WriteRestart(frame);
+}
+//--------------------------------------------------------------------------------------------
+//                                      hand the output of this time to the writer thread
+//--------------------------------------------------------------------------------------------
+void Output::SubmitOutput()
+{
+    writer->Submit();
+}
+//--------------------------------------------------------------------------------------------
 //                                      avergaed values for Poiseuille and Couette flows
 //                                      the average is taken in horizontal diraction
 //--------------------------------------------------------------------------------------------
 void Output::OutAverage(ParticleManager &particles, MLS &mls, QuinticSpline &weight_function, 
                         double Time, Initiation &ini)
 {
-    int i, j, l, n;
-    int gridx, gridy;
-    Vec2d pstn;
-    double rho, pressure, Temperature, x_velocity, y_velocity;
+    int i, j, n;
     double Itime;
     char file_name[150], file_list[110];
 
-        
-    //grid box size
-    gridx = x_cells*hdelta; gridy = y_cells*hdelta;
+    //map the particle states to the grid
+    grid->Map(particles, weight_function, 0);
+    const int gridx = grid->GridX(), gridy = grid->GridY();
         
     //produce output file name
     Itime = Time*1.0e6;
@@ -300,45 +377,18 @@ void Output::OutAverage(ParticleManager &particles, MLS &mls, QuinticSpline &wei
     out<<"title='averaged states' \n";
     out<<"variables=y, p, rho, Ux, Uy, T \n";
         
-    //loop the grid points
-    //NOTE: loop the x direction first and then the y direction!
+    //average the grid points in the x direction
     for(j = 0; j <= gridy; j++) { 
                 
-        l = 0;
-        rho = 0.0; pressure = 0.0; Temperature = 0.0;
-        x_velocity = 0.0; y_velocity = 0.0;
-        for(i = 0; i <= gridx; i++) {
-            pstn[0] = i*delta; pstn[1] = j*delta;
-            //biuld the NNP_list
-            particles.BuildNNP(pstn);
-            //if the NNP list is not empty run MLS approximation
-            if(!particles.NNP_list.empty()) 
-                mls.MLSMapping(pstn, particles.NNP_list, weight_function, 0);
-            n = 0;
-            //iterate this Nearest Neighbor Particle list
-            for (LlistNode<Particle> *p = particles.NNP_list.first(); 
-                 !particles.NNP_list.isEnd(p); 
-                 p = particles.NNP_list.next(p)) {
-                        
-                //get particle data
-                Particle *prtl = particles.NNP_list.retrieve(p);
-
-                rho += prtl->rho*mls.phi[n];
-                pressure += prtl->p*mls.phi[n];
-                Temperature += prtl->T*mls.phi[n];
-                x_velocity += prtl->U[0]*mls.phi[n];
-                y_velocity += prtl->U[1]*mls.phi[n];
-                                
-                n ++;
-            }
-            //clear the NNP_list
-            particles.NNP_list.clear();
-            l ++;
-        }
+        double average[GRID_STATES];
+        for(n = 0; n < GRID_STATES; n++) average[n] = 0.0;
+        for(i = 0; i <= gridx; i++) 
+            for(n = 0; n < GRID_STATES; n++) average[n] += grid->State(i, j)[n];
+        for(n = 0; n < GRID_STATES; n++) average[n] /= double(gridx + 1);
                 
-        out<<pstn[1]<<"  "<<pressure/double(l)<<"  "
-           <<rho/double(l)<<"  "<<x_velocity/double(l)<<"  "
-           <<y_velocity/double(l)<<"  "<<Temperature/double(l)<<"\n";
+        out<<j*delta<<"  "<<average[GRID_P]<<"  "
+           <<average[GRID_RHO]<<"  "<<average[GRID_UX]<<"  "
+           <<average[GRID_UY]<<"  "<<average[GRID_T]<<"\n";
     }
     out.close();
 }
@@ -11,8 +11,16 @@ class ParticleManager;
 class  MLS;
 class QuinticSpline;
 class Initiation;
+class OutputFrame;
+class OutputWriter;
+class MovieWriter;
+class GridMapping;
 
 /// Output class 
+///
+/// The particle files, the restart file and the movie frame of one time are collected
+/// from a snapshot of the particles and written by a background thread after
+/// SubmitOutput(), while the computation goes on.
 class Output {
         
     ///the project name
@@ -26,10 +34,34 @@ class Output {
     ///the ration between smoothing length and inital particle distance
     int hdelta; 
 
+    ///format of the restart file, 0: text, 1: binary
+    int restart_format;
+    ///the thread writing the particle files, the restart file and the movie
+    OutputWriter *writer;
+    ///format of the movie, 0: text, 1: binary, and the compression of the binary movie
+    int movie_format, movie_compression;
+    ///box of the positions in the binary movie
+    Vec2d box_size;
+    ///the binary movie
+    MovieWriter *movie;
+    ///mapping of the particle states to the output grid
+    GridMapping *grid;
+
+    ///write the particle positions from a snapshot
+    void WriteParticles(const OutputFrame &frame);
+    ///write the restart file from a snapshot
+    void WriteRestart(const OutputFrame &frame);
+    ///Output the n real particles of a snapshot for restart in the binary format
+    void OutBinaryRestart(const OutputFrame &frame, int n, const char *outputfile);
+    ///write a frame of the particle movie from a snapshot
+    void WriteMovie(const OutputFrame &frame);
+
 public:
 
     ///constructor
     Output(Initiation &ini);
+    ///destructor, writes the remaining output
+    ~Output();
 
     ///output particle positions respected different materials
     void OutputParticles(Hydrodynamics &hydro, Boundary &boundary, 
@@ -40,8 +72,12 @@ public:
     ///Output data for restart
     void OutRestart(Hydrodynamics &hydro, double Time, Initiation &ini);
     ///a movie for particle motion
-    void CreatParticleMovie();
+    void CreatParticleMovie(Hydrodynamics &hydro);
     void WriteParticleMovie(Hydrodynamics &hydro, double Time, Initiation &ini);
+    ///hand the particle files, the restart file and the movie frame of this time to the writer
+    void SubmitOutput();
+    ///write the files collected in a snapshot
+    void WriteFrame(const OutputFrame &frame);
     ///avergaed values for Poiseuille and Couette flows
     void OutAverage(ParticleManager &particles, MLS &mls, QuinticSpline &weight_function, 
                     double Time, Initiation &ini);
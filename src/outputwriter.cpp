@@ -0,0 +1,186 @@
+// outputwriter.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Background thread writing the output files
+//              outputwriter.cpp
+//----------------------------------------------------------------------------------------
+
+#include <iostream>
+
+#include <cstdlib>
+
+// ***** localincludes *****
+#include "glbcls.h"
+#include "glbfunc.h"
+#include "interaction.h"
+#include "bondlist.h"
+#include "hydrodynamics.h"
+#include "material.h"
+#include "output.h"
+#include "outputwriter.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+OutputFrame::OutputFrame():
+capacity(0), Time(0.0), jobs(0), materials(0), number_of_materials(0), boundary_material(0),
+number_of_real(0), R(0), U(0), dUdt(0), _dU(0), rho(0), p(0), T(0), ID(0), polyID(0),
+material(0), bd(0), random_step(0), random_seed(0)
+{
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+OutputFrame::~OutputFrame()
+{
+    delete[] boundary_material;
+    delete[] R; delete[] U; delete[] dUdt; delete[] _dU;
+    delete[] rho; delete[] p; delete[] T;
+    delete[] ID; delete[] polyID; delete[] material; delete[] bd;
+}
+//----------------------------------------------------------------------------------------
+//                              copy the particle data at the time Time
+//----------------------------------------------------------------------------------------
+void OutputFrame::Snapshot(Hydrodynamics &hydro, double Time)
+{
+    int prtl;
+    ParticleStore &store = hydro.store;
+
+    if(store.number_of_real > capacity) {
+        delete[] R; delete[] U; delete[] dUdt; delete[] _dU;
+        delete[] rho; delete[] p; delete[] T;
+        delete[] ID; delete[] polyID; delete[] material; delete[] bd;
+        capacity = store.number_of_real;
+        R = new Vec2d[capacity]; U = new Vec2d[capacity];
+        dUdt = new Vec2d[capacity]; _dU = new Vec2d[capacity];
+        rho = new double[capacity]; p = new double[capacity]; T = new double[capacity];
+        ID = new long[capacity]; polyID = new long[capacity];
+        material = new int[capacity]; bd = new int[capacity];
+    }
+
+    this->Time = Time;
+    materials = hydro.materials;
+    number_of_real = store.number_of_real;
+    random_step = hydro.random_step;
+    random_seed = hydro.wiener.seed;
+
+    for(prtl = 0; prtl < number_of_real; prtl++) {
+        R[prtl] = store.R[prtl]; U[prtl] = store.U[prtl];
+        dUdt[prtl] = store.dUdt[prtl]; _dU[prtl] = store._dU[prtl];
+        rho[prtl] = store.rho[prtl]; p[prtl] = store.p[prtl]; T[prtl] = store.T[prtl];
+        ID[prtl] = store.ID[prtl]; polyID[prtl] = store.polyID[prtl];
+        material[prtl] = store.mtl[prtl]->number; bd[prtl] = store.bd[prtl];
+    }
+
+    //the materials of the boundary particles
+    for(int k = 0; k < number_of_materials; k++) boundary_material[k] = 0;
+    for(prtl = store.number_of_real; prtl < store.number_of_particles; prtl++)
+        boundary_material[store.mtl[prtl]->number] = 1;
+}
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+OutputWriter::OutputWriter(Output &output, int number_of_materials, int async):
+output(&output), async(async), next(0), open(0), quit(0)
+{
+    for(int k = 0; k < 2; k++) {
+        frames[k].number_of_materials = number_of_materials;
+        frames[k].boundary_material = new int[number_of_materials];
+        posted[k] = 0;
+    }
+    if(!async) return;
+
+    pthread_mutex_init(&lock, 0);
+    pthread_cond_init(&changed, 0);
+    if(pthread_create(&thread, 0, Writer, this) != 0) {
+        cout<<"OutputWriter: Cannot start the writer thread \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+}
+//----------------------------------------------------------------------------------------
+//                              destructor, writes the remaining frames
+//----------------------------------------------------------------------------------------
+OutputWriter::~OutputWriter()
+{
+    Submit();
+    if(!async) return;
+
+    pthread_mutex_lock(&lock);
+    quit = 1;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+    pthread_join(thread, 0);
+
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&lock);
+}
+//----------------------------------------------------------------------------------------
+//                      the frame for the output at the time Time
+//----------------------------------------------------------------------------------------
+OutputFrame &OutputWriter::Stage(Hydrodynamics &hydro, double Time)
+{
+    //the output of another time starts a new frame
+    if(open && frames[next].Time != Time) Submit();
+    if(open) return frames[next];
+
+    //wait until the writer is done with the frame
+    if(async) {
+        pthread_mutex_lock(&lock);
+        while(posted[next]) pthread_cond_wait(&changed, &lock);
+        pthread_mutex_unlock(&lock);
+    }
+    frames[next].jobs = 0;
+    frames[next].Snapshot(hydro, Time);
+    open = 1;
+    return frames[next];
+}
+//----------------------------------------------------------------------------------------
+//                                      write the collected frame
+//----------------------------------------------------------------------------------------
+void OutputWriter::Submit()
+{
+    if(!open) return;
+    open = 0;
+
+    if(!async) {
+        output->WriteFrame(frames[next]);
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    posted[next] = 1;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+    next = 1 - next;
+}
+//----------------------------------------------------------------------------------------
+//                      the loop of the writer thread
+//                      the frames are written in the order they are submitted
+//----------------------------------------------------------------------------------------
+void *OutputWriter::Writer(void *writer)
+{
+    OutputWriter &self = *(OutputWriter *)writer;
+    int current = 0;
+
+    pthread_mutex_lock(&self.lock);
+    while(true) {
+        while(!self.posted[current] && !self.quit) pthread_cond_wait(&self.changed, &self.lock);
+        //nothing left to write
+        if(!self.posted[current]) break;
+        pthread_mutex_unlock(&self.lock);
+
+        self.output->WriteFrame(self.frames[current]);
+
+        pthread_mutex_lock(&self.lock);
+        self.posted[current] = 0;
+        pthread_cond_broadcast(&self.changed);
+        current = 1 - current;
+    }
+    pthread_mutex_unlock(&self.lock);
+    return 0;
+}
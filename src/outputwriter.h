@@ -0,0 +1,103 @@
+/// \file outputwriter.h
+/// \brief Background thread writing the output files
+
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+
+#include <pthread.h>
+
+class Hydrodynamics;
+class Material;
+class Output;
+
+///output files of a frame
+enum { OUTPUT_PARTICLES = 1, OUTPUT_MOVIE = 2, OUTPUT_RESTART = 4 };
+
+/// Snapshot of the real particles for the output files
+class OutputFrame {
+
+    ///length of the arrays
+    int capacity;
+
+public:
+
+    ///time of the snapshot
+    double Time;
+    ///output files to write from the snapshot
+    int jobs;
+    ///the materials of the particles
+    Material *materials;
+    int number_of_materials;
+    ///1 if there are boundary particles of the material
+    int *boundary_material;
+
+    ///number of real particles
+    int number_of_real;
+    ///fields of the real particles
+    Vec2d *R, *U, *dUdt, *_dU;
+    double *rho, *p, *T;
+    long *ID, *polyID;
+    ///material number and boundary type of the real particles
+    int *material, *bd;
+
+    ///counter and seed of the Wiener increments for the restart
+    long random_step;
+    unsigned int random_seed;
+
+    ///constructor
+    OutputFrame();
+    ///destructor
+    ~OutputFrame();
+
+    ///copy the particle data at the time Time
+    void Snapshot(Hydrodynamics &hydro, double Time);
+};
+
+/// Background thread writing the output files
+///
+/// The output of one time is collected in a frame: the first output call of the time
+/// takes a snapshot of the particles and every call adds its file to the frame.
+/// Submit() hands the frame to the writer thread, which formats and writes the files
+/// while the computation goes on. There are two frames, so the snapshot of the next
+/// output time waits for the writer if the frame before the last one is not written yet.
+/// The frames are written in the order they are submitted.
+class OutputWriter {
+
+    ///the output writing the files of a frame
+    Output *output;
+    ///1: the frames are written by the writer thread, 0: by the calling thread
+    int async;
+
+    ///the two frames
+    OutputFrame frames[2];
+    ///the frame collecting the output
+    int next;
+    ///1 if the frame next has a snapshot and is not submitted yet
+    int open;
+    ///1 if the frame is submitted and not written yet
+    int posted[2];
+    ///1 if the writer thread has to stop after the submitted frames
+    int quit;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    ///signaled when a frame is submitted or written
+    pthread_cond_t changed;
+
+    ///the loop of the writer thread
+    static void *Writer(void *writer);
+
+public:
+
+    ///constructor
+    OutputWriter(Output &output, int number_of_materials, int async);
+    ///destructor, writes the remaining frames
+    ~OutputWriter();
+
+    ///the frame for the output at the time Time, with a snapshot of the particles
+    OutputFrame &Stage(Hydrodynamics &hydro, double Time);
+    ///write the collected frame
+    void Submit();
+};
+
+#endif
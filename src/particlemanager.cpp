@@ -13,36 +13,41 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 // ***** local includes *****
 #include "glbcls.h"
 #include "glbfunc.h"
 #include "particlemanager.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
 #include "initiation.h"
 #include "quinticspline.h"
 #include "boundary.h"
-#include "interaction.h"
-#include "particle.h"
 #include "material.h"
+#include "restartfile.h"
 
 using namespace std;
 
 //----------------------------------------------------------------------------------------
 //                                                                      constructor
 //----------------------------------------------------------------------------------------
-ParticleManager::ParticleManager()
+ParticleManager::ParticleManager() : store(0)
 {
 }
 //----------------------------------------------------------------------------------------
 //                                                                      constructor
 //----------------------------------------------------------------------------------------
-ParticleManager::ParticleManager(Initiation &ini)
+ParticleManager::ParticleManager(Initiation &ini) : store(ini.number_of_materials)
 {
         
-    int i;
-        
     //copy properties from class Initiation
     strcpy(Project_name, ini.Project_name);
     number_of_materials = ini.number_of_materials;
@@ -61,237 +66,503 @@ ParticleManager::ParticleManager(Initiation &ini)
         T0 = ini.T0;
     }
 
-    //strore the cell linked lists in a 2-d array
-    cell_lists = new Llist<Particle>*[x_clls];
-    for(i = 0; i < x_clls; i++) cell_lists[i] = new Llist<Particle>[y_clls];
+    //the cell grid, all cells are empty
+    cell_start = new int[x_clls*y_clls + 1];
+    for(int c = 0; c <= x_clls*y_clls; c++) cell_start[c] = 0;
+    particle_index_length = 1024;
+    particle_index = new int[particle_index_length];
+#ifdef _OPENMP
+    cell_count = new int[omp_get_max_threads()*x_clls*y_clls];
+#else
+    cell_count = new int[x_clls*y_clls];
+#endif
+
+    //the nearest neighbor particle list
+
+    //the Verlet pair list
+    skin = ini.verlet_skin;
+    //all candidate pairs have to be found in the rings of surrounding cells
+    //and have to be covered by the layers of boundary particles
+    cell_rings = 1;
+    while(cell_rings*cll_sz < smoothinglength + skin) cell_rings++;
+    verlet_rebuild = true;
+    verlet_capacity = 1024;
+    verlet_org = new int[verlet_capacity];
+    verlet_dest = new int[verlet_capacity];
+    verlet_number = 0;
+    R_verlet_length = 1024;
+    R_verlet = new Vec2d[R_verlet_length];
+
+    //the per-thread pair buffers
+#ifdef _OPENMP
+    number_of_buffers = omp_get_max_threads();
+#else
+    number_of_buffers = 1;
+#endif
 
+    //the colours of the candidate pairs
+    pair_scatter = ini.pair_scatter;
+    verlet_colour_start = new int[Interaction::MAX_COLOURS + 2];
+    verlet_colour_start[0] = 0;
+    colour_capacity = 0;
+    verlet_colour = 0; sorted_org = 0; sorted_dest = 0;
+    colour_mask_length = 1024;
+    colour_mask = new unsigned long long[colour_mask_length];
+    colour_count = new int[number_of_buffers*(Interaction::MAX_COLOURS + 1)];
+    buffer_org = new int*[number_of_buffers];
+    buffer_dest = new int*[number_of_buffers];
+    buffer_number = new int[number_of_buffers];
+    buffer_capacity = new int[number_of_buffers];
+    for(int t = 0; t < number_of_buffers; t++) {
+        buffer_capacity[t] = 1024;
+        buffer_org[t] = new int[buffer_capacity[t]];
+        buffer_dest[t] = new int[buffer_capacity[t]];
+        buffer_number[t] = 0;
+    }
 }
 //----------------------------------------------------------------------------------------
 //                                                              constructor
 //----------------------------------------------------------------------------------------
-ParticleManager::ParticleManager(double cell_size, int x_cells, int y_cells)
+ParticleManager::ParticleManager(double cell_size, int x_cells, int y_cells) : store(0)
 {
 
     cll_sz = cell_size;
     x_clls = x_cells + 2; y_clls = y_cells + 2;
+    cell_rings = 1;
 
 }
 //----------------------------------------------------------------------------------------
-//                              update the cell linked lists for real particles
+//                                      put a particle into a cell
 //----------------------------------------------------------------------------------------
-void ParticleManager::UpdateCellLinkedLists() 
+void ParticleManager::AssignCell(int n, int i, int j)
 {
-        
-    int i, j; //current cell postions
-    int k, m; //possible new cell postions
-
-    //loop on all cells
-    for(i = 0; i < x_clls; i++) {
-        for(j = 0; j < y_clls; j++) { 
-
-            //iterate this cell list
-            LlistNode<Particle> *p = cell_lists[i][j].first(); 
-            //if the list is empty or the node pisition is at the end
-            while(!cell_lists[i][j].isEnd(p)) {
-                //check the position of the real particle
-                Particle *prtl = cell_lists[i][j].retrieve(p);
-                if(prtl->bd == 0) {
-                    //where is the particle
-                    k = int ((prtl->R[0] + cll_sz)/ cll_sz);
-                    m = int ((prtl->R[1] + cll_sz)/ cll_sz);
-                                
-                    //if the partilce run out of the current cell
-                    if(k != i || m !=j) {
-                        //delete the current node
-                        cell_lists[i][j].remove(p);
-                        //insert it to the new cell linked list
-                        cell_lists[k][m].insert(cell_lists[k][m].first(), prtl);
-                    } else p = cell_lists[i][j].next(p);
-                } else p = cell_lists[i][j].next(p);
-            }
-
-        }
-    }
+    store.cell_i[n] = i; store.cell_j[n] = j;
+}
+//----------------------------------------------------------------------------------------
+//                      put a real particle into the inner cell of its position
+//----------------------------------------------------------------------------------------
+void ParticleManager::AssignInnerCell(int n)
+{
+    //where is the particle
+    const int k = int ((store.R[n][0] + cll_sz)/ cll_sz);
+    const int m = int ((store.R[n][1] + cll_sz)/ cll_sz);
+    //a particle exactly on the east or north side belongs to the last inner cell
+    store.cell_i[n] = k < 1 ? 1 : (k > x_clls - 2 ? x_clls - 2 : k);
+    store.cell_j[n] = m < 1 ? 1 : (m > y_clls - 2 ? y_clls - 2 : m);
 }
 //----------------------------------------------------------------------------------------
-//                                              do NNP search and biuld the NNP list
+//                      rebuild the cell grid by a counting sort on the cell positions
 //----------------------------------------------------------------------------------------
-void ParticleManager::BuildNNP(Vec2d &point)
+void ParticleManager::SortParticles()
 {
-    int i, j; //current cell postions
-    int k, m; //possible new cell postions
-    double dstc; //distance
+    const int number_of_cells = x_clls*y_clls;
+    const int number_of_particles = store.number_of_particles;
+
+    //the store may have grown since the last sort
+    if(number_of_particles > particle_index_length) {
+        while(particle_index_length < number_of_particles) particle_index_length *= 2;
+        delete[] particle_index;
+        particle_index = new int[particle_index_length];
+    }
 
-    //clear the list first
-    NNP_list.clear_data();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        int c, n;
+        int thread_num = 1, this_thread_num = 0;
+#ifdef _OPENMP
+        thread_num = omp_get_num_threads();
+        this_thread_num = omp_get_thread_num();
+#endif
+        //each thread bins a contiguous chunk of particles
+        const int first = int((long)number_of_particles*this_thread_num/thread_num);
+        const int last = int((long)number_of_particles*(this_thread_num + 1)/thread_num);
+        int *count = cell_count + this_thread_num*number_of_cells;
 
-    //where is the point
-    k = int ((point[0] + cll_sz)/ cll_sz);
-    m = int ((point[1] + cll_sz)/ cll_sz);
+        //count the particles of the chunk in each cell
+        for(c = 0; c < number_of_cells; c++) count[c] = 0;
+        for(n = first; n < last; n++) count[store.cell_i[n]*y_clls + store.cell_j[n]]++;
 
-    //loop on this and all surrounding cells
-    for(i = k - 1; i <= k + 1; i++) {
-        for(j = m - 1; j <= m + 1; j++) { 
-            if(i < x_clls && j < y_clls && i >= 0 && j >= 0) {
-                //iterate this cell list
-                for (LlistNode<Particle> *p = cell_lists[i][j].first(); 
-                     !cell_lists[i][j].isEnd(p); 
-                     p = cell_lists[i][j].next(p)) {
-
-                    //check the position of the particle
-                    //and insert the nearest particle to the list
-                    Particle *prtl = cell_lists[i][j].retrieve(p);
-                    dstc = v_distance(point, prtl->R);
-                    if(dstc < smoothinglength) {
-                        NNP_list.insert(NNP_list.first(), prtl);
-                    }
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+        {
+            //exclusive prefix sum, cell by cell and thread by thread within a cell
+            int sum = 0;
+            for(c = 0; c < number_of_cells; c++) {
+                cell_start[c] = sum;
+                for(int t = 0; t < thread_num; t++) {
+                    int k = cell_count[t*number_of_cells + c];
+                    cell_count[t*number_of_cells + c] = sum;
+                    sum += k;
                 }
             }
+            cell_start[number_of_cells] = sum;
         }
+
+        //scatter the particle indices, the order of the particles is kept within each cell
+        for(n = first; n < last; n++) 
+            particle_index[count[store.cell_i[n]*y_clls + store.cell_j[n]]++] = n;
     }
 }
 //----------------------------------------------------------------------------------------
-//                              do NNP search and biuld the NNP list for MLS Mapping
+//                              update the cell positions of the real particles
+//                              the cell grid is rebuilt with the boundary particles
 //----------------------------------------------------------------------------------------
-void ParticleManager::BuildNNP_MLSMapping(Vec2d &point)
+void ParticleManager::UpdateCells() 
 {
-    int i, j; //current cell postions
-    int k, m; //possible new cell postions
-    double dstc; //distance
-
-
-    //where is the point
-    k = int ((point[0] + cll_sz)/ cll_sz);
-    m = int ((point[1] + cll_sz)/ cll_sz);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int n = 0; n < store.number_of_real; n++) 
+        if(store.bd[n] == 0) AssignInnerCell(n);
+}
+//----------------------------------------------------------------------------------------
+//              the particles in cell (k, m) and its surrounding cells, in the order of ForNeighbours
+//----------------------------------------------------------------------------------------
+int ParticleManager::CellNeighbours(int k, int m, int *&list, int &capacity) const
+{
+    int i, j, s, t; 
+    int number = 0;
 
-    //loop on this and all surrounding cells
-    for(i = k - 1; i <= k + 1; i++) {
-        for(j = m - 1; j <= m + 1; j++) { 
+    //loop on this and all surrounding cells, wrapped around in the periodic directions
+    for(s = k - 1; s <= k + 1; s++) {
+        for(t = m - 1; t <= m + 1; t++) { 
+            i = WrapCell(s, x_clls, store.period[0]); j = WrapCell(t, y_clls, store.period[1]);
             if(i < x_clls && j < y_clls && i >= 0 && j >= 0) {
-                //iterate this cell list
-                for (LlistNode<Particle> *p = cell_lists[i][j].first(); 
-                     !cell_lists[i][j].isEnd(p); 
-                     p = cell_lists[i][j].next(p)) {
-
-                    //check the position of the real particle
-                    //and insert the nearest particle to the list
-                    Particle *prtl = cell_lists[i][j].retrieve(p);
-                    dstc = v_distance(point, prtl->R);
-                    //only real particles included
-                    if(dstc < smoothinglength && prtl->bd == 0) {
-                        NNP_list.insert(NNP_list.first(), prtl);
-                    }
+                //the list grows if the particles of the cell do not fit
+                const int size = CellEnd(i, j) - CellBegin(i, j);
+                if(number + size > capacity) {
+                    int *larger = new int[2*(number + size)];
+                    for(int l = 0; l < number; l++) larger[l] = list[l];
+                    delete[] list;
+                    list = larger;
+                    capacity = 2*(number + size);
                 }
+                for(int l = CellBegin(i, j); l < CellEnd(i, j); l++) list[number++] = particle_index[l];
             }
         }
     }
+    return number;
 }
 //----------------------------------------------------------------------------------------
-//                                      build the interaction (particle pair) list
+//                                      append a pair to a growing pair buffer
+//----------------------------------------------------------------------------------------
+static void AppendPair(int prtl_org, int prtl_dest, int *&org, int *&dest, int &number, int &capacity)
+{
+    //the buffer is full
+    if(number == capacity) {
+        int *new_org = new int[2*capacity];
+        int *new_dest = new int[2*capacity];
+        for(int n = 0; n < number; n++) {
+            new_org[n] = org[n]; new_dest[n] = dest[n];
+        }
+        delete[] org; delete[] dest;
+        org = new_org; dest = new_dest;
+        capacity *= 2;
+    }
+    org[number] = prtl_org;
+    dest[number] = prtl_dest;
+    number++;
+}
+//----------------------------------------------------------------------------------------
+//                      check a pair of particles and append it to a thread buffer
+//----------------------------------------------------------------------------------------
+void ParticleManager::AddVerletPair(int prtl_a, int prtl_b, double cutoffsquare, 
+                                    int *&org, int *&dest, int &number, int &capacity)
+{
+    //at least one real particle, boundary particles do not interact with each other
+    if(store.bd[prtl_a] != 0 && store.bd[prtl_b] != 0) return;
+
+    //calculate distance
+    if(v_sq(store.Separation(prtl_a, prtl_b)) > cutoffsquare) return;
+
+    //the original particle has the larger ID, boundary particles have ID 0
+    if(store.ID[prtl_a] >= store.ID[prtl_b]) AppendPair(prtl_a, prtl_b, org, dest, number, capacity);
+    else AppendPair(prtl_b, prtl_a, org, dest, number, capacity);
+}
 //----------------------------------------------------------------------------------------
-void ParticleManager::BuildInteraction(Llist<Interaction> &interactions, Llist<Particle> &particle_list, 
-                                       Force **forces, QuinticSpline &weight_function, Initiation& ini)
+//                                      search the candidate pairs in the cells
+//----------------------------------------------------------------------------------------
+void ParticleManager::BuildVerletList()
 {
-    LlistNode<Interaction> *current = interactions.first();
-    bool used_up_old = interactions.isEnd(current);
-    LlistNode<Interaction> *first_unused;
-    int old_length = interactions.length();
+    //search radius
+    const double cutoffsquare = (smoothinglength + skin)*(smoothinglength + skin);
 
 #ifdef _OPENMP
-#pragma omp parallel shared(used_up_old, first_unused, old_length) firstprivate(current)
+#pragma omp parallel
 #endif
     {
-        int i, j, k, m;
-        double dstc; //distance
-        
-        //clear the list first
-        //interactions.clear_data();
+        int i, j, k, m, l, n, s, t;
+        int thread_num = 1, this_thread_num = 0;
+#ifdef _OPENMP
+        thread_num = omp_get_num_threads();
+        this_thread_num = omp_get_thread_num();
+#endif
+        //each thread searches an equal share of the particles sorted by cell into its own buffer,
+        //the cells are split between threads where the share ends
+        const int number_of_particles = cell_start[x_clls*y_clls];
+        const int first = int((long)number_of_particles*this_thread_num/thread_num);
+        const int last = int((long)number_of_particles*(this_thread_num + 1)/thread_num);
+        int *org = buffer_org[this_thread_num], *dest = buffer_dest[this_thread_num];
+        int number = 0, capacity = buffer_capacity[this_thread_num];
+
+        //the cell of the first particle, from the particle counts in cell_start
+        int lower = 0, upper = x_clls*y_clls;
+        while(upper - lower > 1) {
+            const int middle = (lower + upper)/2;
+            if(cell_start[middle] <= first) lower = middle; 
+            else upper = middle;
+        }
+        int cell = lower;
+
+        //iterate the particles of the cells including the boundary cells
+        //each pair of particles is found once: inside a cell or from the cell with the smaller (i, j)
+        for(l = first; l < last; l++) {
+            int prtl = particle_index[l];
+            while(cell_start[cell + 1] <= l) cell++;
+            i = cell/y_clls; j = cell%y_clls;
+
+            //this cell, the self pair included
+            for(n = l; n < CellEnd(i, j); n++) 
+                AddVerletPair(prtl, particle_index[n], cutoffsquare, org, dest, number, capacity);
+
+            //the forward half of the surrounding cells in cell_rings rings, 
+            //wrapped around in the periodic directions
+            for(s = 0; s <= cell_rings; s++) {
+                for(t = (s == 0 ? 1 : -cell_rings); t <= cell_rings; t++) {
+                    k = WrapCell(i + s, x_clls, store.period[0]); 
+                    m = WrapCell(j + t, y_clls, store.period[1]);
+                    if(k < x_clls && m >= 0 && m < y_clls)
+                        for(n = CellBegin(k, m); n < CellEnd(k, m); n++) 
+                            AddVerletPair(prtl, particle_index[n], cutoffsquare, org, dest, number, capacity);
+                }
+            }
+        }
 
-        int current_used = 0;
+        buffer_org[this_thread_num] = org; buffer_dest[this_thread_num] = dest;
+        buffer_number[this_thread_num] = number; buffer_capacity[this_thread_num] = capacity;
 
 #ifdef _OPENMP
-        int current_thread = 0;
-        int thread_num = omp_get_num_threads();
-        int this_thread_num = omp_get_thread_num();
-        
-        static bool not_displayed_thread_num = true;
-        if (not_displayed_thread_num && this_thread_num == 0) {
-            not_displayed_thread_num = false;
-            cout << "Number of threads is: " << thread_num << endl;
-        }
+#pragma omp barrier
+#pragma omp single
 #endif
+        {
+            //total number of candidate pairs
+            verlet_number = 0;
+            for(t = 0; t < thread_num; t++) verlet_number += buffer_number[t];
+            if(verlet_number > verlet_capacity) {
+                while(verlet_capacity < verlet_number) verlet_capacity *= 2;
+                delete[] verlet_org; delete[] verlet_dest;
+                verlet_org = new int[verlet_capacity];
+                verlet_dest = new int[verlet_capacity];
+            }
+        }
 
-        //iterate particles on the particle list
-        for (LlistNode<Particle> *p = particle_list.first(); 
-             !particle_list.isEnd(p); 
-             p = particle_list.next(p)) {
-                                        
-            //origin particle
-            Particle *prtl_org = particle_list.retrieve(p);
+        //join the buffers in the order of the threads
+        int offset = 0;
+        for(t = 0; t < this_thread_num; t++) offset += buffer_number[t];
+        for(n = 0; n < number; n++) {
+            verlet_org[offset + n] = org[n];
+            verlet_dest[offset + n] = dest[n];
+        }
+    }
 
-            if(prtl_org->bd == 0) {
-                
-                //where is the particle
-                i = int ((prtl_org->R[0] + cll_sz)/ cll_sz);
-                j = int ((prtl_org->R[1] + cll_sz)/ cll_sz);
-
-                //loop on this and all surrounding cells
-                for(k = i - 1; k <= i + 1; k++) 
-                    for(m = j - 1; m <= j + 1; m++) { 
-                        //iterate this cell list
-                        for (LlistNode<Particle> *p1 = cell_lists[k][m].first(); 
-                             !cell_lists[k][m].isEnd(p1); 
-                             p1 = cell_lists[k][m].next(p1)) {
-
-                            //destination particle
-                            Particle *prtl_dest = cell_lists[k][m].retrieve(p1);
-                
-                            //calculate distance
-                            dstc = v_sq(prtl_org->R - prtl_dest->R);
-                            if(dstc <= smoothinglengthsquare && prtl_org->ID >= prtl_dest->ID) {
-                                if(current_used == old_length) {
+    //remember the positions of the real particles
+    if(store.number_of_real > R_verlet_length) {
+        while(R_verlet_length < store.number_of_real) R_verlet_length *= 2;
+        delete[] R_verlet;
+        R_verlet = new Vec2d[R_verlet_length];
+    }
+    for(int n = 0; n < store.number_of_real; n++) R_verlet[n] = store.R[n];
+
+    //sort the candidate pairs into batches for the parallel summation
+    if(pair_scatter == 1) ColourVerletList();
+
+    verlet_rebuild = false;
+}
+//----------------------------------------------------------------------------------------
+//                      sort the candidate pairs into colours without common particles
+//                      greedy colouring: each pair takes the first colour
+//                      not yet used by any particle it writes to
+//                      the boundary particles are not rebuilt before the next pair search,
+//                      so any subset of a colour is still free of common particles
+//----------------------------------------------------------------------------------------
+void ParticleManager::ColourVerletList()
+{
+    int k, c;
+    const int MAX_COLOURS = Interaction::MAX_COLOURS;
+
+    //the particles and pairs may have grown since the last colouring
+    if(store.number_of_particles > colour_mask_length) {
+        while(colour_mask_length < store.number_of_particles) colour_mask_length *= 2;
+        delete[] colour_mask;
+        colour_mask = new unsigned long long[colour_mask_length];
+    }
+    //the sort buffers are swapped with the candidate pairs, so they have the same length
+    if(colour_capacity < verlet_capacity) {
+        colour_capacity = verlet_capacity;
+        delete[] verlet_colour; delete[] sorted_org; delete[] sorted_dest;
+        verlet_colour = new int[colour_capacity];
+        sorted_org = new int[colour_capacity];
+        sorted_dest = new int[colour_capacity];
+    }
+    for(k = 0; k < store.number_of_particles; k++) colour_mask[k] = 0;
+
+    int count[MAX_COLOURS + 1];
+    for(c = 0; c <= MAX_COLOURS; c++) count[c] = 0;
+
+    for(k = 0; k < verlet_number; k++) {
+        const int i = verlet_org[k], j = verlet_dest[k];
+        //random forces on a periodic image go to its real particle
+        const int r = store.bd_type[j] == 1 ? store.rl_prtl[j] : j;
+        const unsigned long long used = colour_mask[i] | colour_mask[j] | colour_mask[r];
+
+        //the first free colour, MAX_COLOURS if there is none
+        c = 0;
+        while(c < MAX_COLOURS && (used >> c & 1ULL)) c++;
+        if(c < MAX_COLOURS) {
+            const unsigned long long bit = 1ULL << c;
+            colour_mask[i] |= bit; colour_mask[j] |= bit; colour_mask[r] |= bit;
+        }
+        verlet_colour[k] = c;
+        count[c]++;
+    }
+
+    //start of each colour, the last colour holds the pairs without a free colour
+    verlet_colour_start[0] = 0;
+    for(c = 0; c <= MAX_COLOURS; c++) verlet_colour_start[c + 1] = verlet_colour_start[c] + count[c];
+
+    //sort the pairs by colour, the pair order is kept within a colour
+    for(c = 0; c <= MAX_COLOURS; c++) count[c] = verlet_colour_start[c];
+    for(k = 0; k < verlet_number; k++) {
+        const int n = count[verlet_colour[k]]++;
+        sorted_org[n] = verlet_org[k];
+        sorted_dest[n] = verlet_dest[k];
+    }
+    int *swap = verlet_org; verlet_org = sorted_org; sorted_org = swap;
+    swap = verlet_dest; verlet_dest = sorted_dest; sorted_dest = swap;
+}
+//----------------------------------------------------------------------------------------
+//                      check the real particle displacements since the last pair search
+//----------------------------------------------------------------------------------------
+bool ParticleManager::CheckVerletList()
+{
+    //without skin the pairs are searched at every time step
+    if(skin == 0.0 || verlet_rebuild) return verlet_rebuild = true;
+
+    //the largest displacement of a real particle
+    double max_dsp = 0.0;
 #ifdef _OPENMP
-                                    if (this_thread_num == current_thread) {
+#pragma omp parallel for reduction(max:max_dsp)
 #endif
-                                        Interaction *pair = new Interaction(prtl_org, prtl_dest, 
-												forces, weight_function, sqrt(dstc), ini);
+    for(int n = 0; n < store.number_of_real; n++) {
+        double dsp = v_sq(store.Wrap(store.R[n] - R_verlet[n]));
+        if(dsp > max_dsp) max_dsp = dsp;
+    }
+
+    //two particles may have approached each other by twice the largest displacement
+    verlet_rebuild = 4.0*max_dsp > skin*skin;
+    return verlet_rebuild;
+}
+//----------------------------------------------------------------------------------------
+//                                      build the interaction (particle pair) list
+//                              from the candidate pairs inside the support of the kernel
+//                              the pair values are computed by the sweep Interaction::Renew
+//----------------------------------------------------------------------------------------
+void ParticleManager::BuildInteraction(Interaction &interactions, 
+                                       Force **forces, QuinticSpline &weight_function)
+{
+    //search the candidate pairs again
+    if(verlet_rebuild) BuildVerletList();
+    //without skin the pairs are searched at every time step
+    if(skin == 0.0) verlet_rebuild = true;
+
 #ifdef _OPENMP
-#pragma omp critical
+    static bool not_displayed_thread_num = true;
+    if (not_displayed_thread_num) {
+        not_displayed_thread_num = false;
+        cout << "Number of threads is: " << omp_get_max_threads() << endl;
+    }
 #endif
-                                        {interactions.insert(current, pair);}
+
+    interactions.NewList(forces, weight_function);
 #ifdef _OPENMP
-                                    }
+#pragma omp parallel
 #endif
-                                }
-                                else {
+    {
+        int k, n, t;
+        double dstc; //distance
+        int thread_num = 1, this_thread_num = 0;
 #ifdef _OPENMP
-                                    if (this_thread_num == current_thread)
+        thread_num = omp_get_num_threads();
+        this_thread_num = omp_get_thread_num();
 #endif
-                                        interactions.retrieve(current)->NewInteraction(prtl_org, prtl_dest, forces, weight_function, sqrt(dstc));
-                                    current = interactions.next(current);
-                                    current_used++;
-                                }
+        //each thread picks the pairs from a contiguous chunk of the candidate pairs
+        const int first = int((long)verlet_number*this_thread_num/thread_num);
+        const int last = int((long)verlet_number*(this_thread_num + 1)/thread_num);
+        int *org = buffer_org[this_thread_num], *dest = buffer_dest[this_thread_num];
+        int number = 0, capacity = buffer_capacity[this_thread_num];
+        //pairs kept of each colour, the candidate pairs are sorted by colour
+        int *count = colour_count + this_thread_num*(Interaction::MAX_COLOURS + 1);
+        int c = 0;
+        if(pair_scatter == 1) {
+            for(c = 0; c <= Interaction::MAX_COLOURS; c++) count[c] = 0;
+            c = 0;
+            while(verlet_colour_start[c + 1] <= first && c < Interaction::MAX_COLOURS) c++;
+        }
+
+        for(k = first; k < last; k++) {
+            //calculate distance
+            dstc = v_sq(store.Separation(verlet_org[k], verlet_dest[k]));
+            if(dstc <= smoothinglengthsquare) {
+                AppendPair(verlet_org[k], verlet_dest[k], org, dest, number, capacity);
+                if(pair_scatter == 1) {
+                    while(verlet_colour_start[c + 1] <= k) c++;
+                    count[c]++;
+                }
+            }
+        }
+
+        buffer_org[this_thread_num] = org; buffer_dest[this_thread_num] = dest;
+        buffer_number[this_thread_num] = number; buffer_capacity[this_thread_num] = capacity;
+
 #ifdef _OPENMP
-                                current_thread++;
-                                if (current_thread == thread_num)
-                                    current_thread = 0;
+#pragma omp barrier
+#pragma omp single
 #endif
-                            }
-                        }
-                    }
+        {
+            //total number of pairs
+            int number_of_pairs = 0;
+            for(t = 0; t < thread_num; t++) number_of_pairs += buffer_number[t];
+            interactions.Resize(number_of_pairs);
+
+            //the kept pairs are still sorted by colour
+            if(pair_scatter == 1) {
+                interactions.colour_start[0] = 0;
+                for(c = 0; c <= Interaction::MAX_COLOURS; c++) {
+                    int kept = 0;
+                    for(t = 0; t < thread_num; t++) kept += colour_count[t*(Interaction::MAX_COLOURS + 1) + c];
+                    interactions.colour_start[c + 1] = interactions.colour_start[c] + kept;
+                    if(kept > 0) interactions.number_of_colours = c + 1;
+                }
             }
         }
-        if (current_used == old_length)
-            used_up_old = true;
-        else
-            first_unused = current;
-    }
-    if (!used_up_old) {
-        while (!interactions.isEnd(first_unused)) { delete interactions.retrieve(first_unused); interactions.remove(first_unused); }
+
+        //join the buffers in the order of the threads,
+        //the pairs are in the same order as found by one thread
+        int offset = 0;
+        for(t = 0; t < this_thread_num; t++) offset += buffer_number[t];
+        for(n = 0; n < number; n++) {
+            interactions.Org[offset + n] = org[n];
+            interactions.Dest[offset + n] = dest[n];
+        }
     }
 }
 //----------------------------------------------------------------------------------------
-//                                      buid the initial particles and the linked lists
+//                                      buid the initial particles and put them into cells
 //----------------------------------------------------------------------------------------
 void ParticleManager::BiuldRealParticles(Hydrodynamics &hydro, Initiation &ini)
 {
@@ -340,9 +611,9 @@ pka[18]={0,1,2,3,6,5,4,7,8,9,0,0,0,0,0,0,0,0};
                         }
 
                         //creat a new real particle
-                        Particle *prtl = new Particle( position, velocity, density, pressure, Temperature, 
-                                                       hydro.materials[material_no]);
-						pk=prtl->ID;
+                        int prtl = store.AddReal( position, velocity, density, pressure, Temperature, 
+                                                  hydro.materials[material_no]);
+						pk=store.ID[prtl];
 					//	if(pk%3==1||pk%3==2)
 					//	{
 					//	prtl->polyID = pj;
@@ -363,9 +634,9 @@ pka[18]={0,1,2,3,6,5,4,7,8,9,0,0,0,0,0,0,0,0};
 if(pk%18>0&&pk%18<10)
 {
 pj=pk%18;
-prtl->polyID=(pk/18)*18+pka[pj];}
+store.polyID[prtl]=(pk/18)*18+pka[pj];}
 else
-{prtl->polyID=0;
+{store.polyID[prtl]=0;
 }
 
 //if(pk%27>0&&pk%54<10)
@@ -396,14 +667,10 @@ else
 //{prtl->polyID=0;
 //}
 
-std::cerr<<"polyID"<<prtl->polyID<<"\n";
-                        prtl->cell_i = i; prtl->cell_j = j; 
+std::cerr<<"polyID"<<store.polyID[prtl]<<"\n";
                                                 
-                        //insert its poistion on the particle list
-                        hydro.particle_list.insert(hydro.particle_list.first(), prtl);
-
-                        //insert the position into corresponding cell list
-                        cell_lists[i][j].insert(cell_lists[i][j].first(), prtl);
+                        //put it into the corresponding cell
+                        AssignCell(prtl, i, j);
 
                     }
                 }
@@ -415,12 +682,15 @@ std::cerr<<"polyID"<<prtl->polyID<<"\n";
     if(initial_condition==1) {  
 
         int n, N;
-        char inputfile[25];
+        char inputfile[150];
         char material_name[25];
                 
         //the restart file name
         strcpy(inputfile, Project_name);
         strcat(inputfile, ".rst");
+
+        //the binary restart file is used directly from memory
+        if(ReadBinaryRestart(hydro, ini, inputfile)) return;
         
         //check if the restart exist
         ifstream fin(inputfile, ios::in);
@@ -451,18 +721,11 @@ std::cerr<<"polyID"<<prtl->polyID<<"\n";
             if(material_no != -1) {     
                                         
                 pressure = hydro.materials[material_no].get_p(density);
-                Particle *prtl = new Particle( position, velocity, density, pressure, Temperature, 
-                                               hydro.materials[material_no]);
-                //insert its poistion on the particle list
-                hydro.particle_list.insert(hydro.particle_list.first(), prtl);
+                int prtl = store.AddReal( position, velocity, density, pressure, Temperature, 
+                                          hydro.materials[material_no]);
                                         
-                //where is the particle
-                i = int (prtl->R[0] / cll_sz) + 1;
-                j = int (prtl->R[1] / cll_sz) + 1;
-                                        
-                prtl->cell_i = i; prtl->cell_j = j; 
-                //insert the position into corresponding cell list
-                cell_lists[i][j].insert(cell_lists[i][j].first(), prtl);
+                //put it into the corresponding cell
+                AssignInnerCell(prtl);
 
             } else {
                 cout<<"The material in the restart file is not used by the program! \n";
@@ -474,7 +737,91 @@ std::cerr<<"polyID"<<prtl->polyID<<"\n";
     }
 }
 //----------------------------------------------------------------------------------------
-//                              buid the initial wall particles and the linked lists
+//                      buid the real particles from a binary restart file
+//                      false if the file is not a binary restart file
+//----------------------------------------------------------------------------------------
+bool ParticleManager::ReadBinaryRestart(Hydrodynamics &hydro, Initiation &ini, const char *inputfile)
+{
+    int k, n;
+
+    const int file = open(inputfile, O_RDONLY);
+    if(file < 0) return false;
+    struct stat file_stat;
+    if(fstat(file, &file_stat) != 0 || file_stat.st_size < (off_t)sizeof(RestartHeader)) {
+        close(file);
+        return false;
+    }
+    const long long size = file_stat.st_size;
+    void *map = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(map == MAP_FAILED) {
+        cout<<"Initialtion: Cannot map "<< inputfile <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    const char *data = (const char *)map;
+    const RestartHeader &header = *(const RestartHeader *)data;
+
+    //a text restart file
+    if(strncmp(header.magic, RESTART_MAGIC, sizeof(header.magic)) != 0) {
+        munmap(map, size);
+        return false;
+    }
+    const RestartLayout layout(header.number_of_materials, header.number_of_particles);
+    if(header.version != RESTART_VERSION || layout.size != size || !RestartByteOrder()) {
+        cout<<"Initialtion: "<< inputfile <<" is not a binary restart file of version "<<RESTART_VERSION
+            <<" for this machine \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    cout<<"Initialtion: Read real particle data from the binary file "<< inputfile <<" \n"; 
+
+    //material numbers of the file to the materials used by the program
+    int *material_no = new int[header.number_of_materials];
+    for(k = 0; k < header.number_of_materials; k++) {
+        const char *name = data + layout.materials + k*RESTART_NAME_LENGTH;
+        material_no[k] = -1;
+        for(n = 0; n < number_of_materials; n++) 
+            if(strncmp(name, hydro.materials[n].material_name, RESTART_NAME_LENGTH) == 0) material_no[k] = n;
+    }
+
+    //the particle fields in the file
+    const Vec2d *R = (const Vec2d *)(data + layout.R), *U = (const Vec2d *)(data + layout.U);
+    //the pressure in the file is not read, it follows from the density as for the text file
+    const double *rho = (const double *)(data + layout.rho);
+    const double *T = (const double *)(data + layout.T);
+    const long long *polyID = (const long long *)(data + layout.polyID);
+    const long long *ID = (const long long *)(data + layout.ID);
+    const int *material = (const int *)(data + layout.material);
+
+    for(n = 0; n < header.number_of_particles; n++) {
+        if(material[n] < 0 || material[n] >= header.number_of_materials || material_no[material[n]] == -1) {
+            cout<<"The material in the restart file is not used by the program! \n";
+            std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+            exit(1);
+        }
+        Material &mtl = hydro.materials[material_no[material[n]]];
+        const int prtl = store.AddReal(R[n], U[n], rho[n], mtl.get_p(rho[n]), T[n], mtl);
+        store.ID[prtl] = ID[n];
+        store.polyID[prtl] = polyID[n];
+        if(ID[n] > store.ID_max) store.ID_max = ID[n];
+
+        //put it into the corresponding cell
+        AssignInnerCell(prtl);
+    }
+
+    //the new starting time and the random numbers continue from the restart
+    ini.Start_time = header.time;
+    ini.End_time += ini.Start_time;
+    hydro.random_step = header.random_step;
+    hydro.wiener.seed = (unsigned int)header.random_seed;
+
+    delete[] material_no;
+    munmap(map, size);
+    return true;
+}
+//----------------------------------------------------------------------------------------
+//                              buid the initial wall particles and put them into cells
 //----------------------------------------------------------------------------------------
 void ParticleManager::BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini, Boundary &boundary)
 {
@@ -488,15 +835,11 @@ void ParticleManager::BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini,
             //creat a new wall particle
             for(k = 0; k < hdelta; k++)
                 for(m = 0; m < hdelta; m++) {
-                    Particle *prtl = new Particle( -1*cll_sz + (k + 0.5)*delta, (j - 1)*cll_sz + (m + 0.5)*delta, 
+                    int prtl = store.AddWall( -1*cll_sz + (k + 0.5)*delta, (j - 1)*cll_sz + (m + 0.5)*delta, 
                                                    0.0, 0.0, cll_sz - (k + 0.5)*delta, 1.0, 0.0, hydro.materials[0]);
-                    // prtl->polyID=prtl->ID;
-                    prtl->cell_i = 0; prtl->cell_j = j; 
-                    //insert its poistion on the particle list
-                    hydro.particle_list.insert(hydro.particle_list.first(), prtl);
 
-                    //insert the position into corresponding cell list
-                    cell_lists[0][j].insert(cell_lists[0][j].first(), prtl);
+                    //put it into the corresponding cell
+                    AssignCell(prtl, 0, j);
 
                 }
         }
@@ -510,15 +853,11 @@ void ParticleManager::BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini,
             //creat a new wall particle
             for(k = 0; k < hdelta; k++)
                 for(m = 0; m < hdelta; m++) {
-                    Particle *prtl = new Particle( (x_clls - 2)*cll_sz + (k + 0.5)*delta, (j - 1)*cll_sz + (m + 0.5)*delta, 
+                    int prtl = store.AddWall( (x_clls - 2)*cll_sz + (k + 0.5)*delta, (j - 1)*cll_sz + (m + 0.5)*delta, 
                                                    0.0, 0.0, (k + 0.5)*delta, 1.0, 0.0, hydro.materials[0]);
 
-                    prtl->cell_i = x_clls - 1; prtl->cell_j = j; 
-                    //insert its poistion on the particle list
-                    hydro.particle_list.insert(hydro.particle_list.first(), prtl);
-
-                    //insert the position into corresponding cell list
-                    cell_lists[x_clls - 1][j].insert(cell_lists[x_clls - 1][j].first(), prtl);
+                    //put it into the corresponding cell
+                    AssignCell(prtl, x_clls - 1, j);
 
                 }
         }
@@ -532,15 +871,11 @@ void ParticleManager::BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini,
             //creat a new wall particle
             for(k = 0; k < hdelta; k++)
                 for(m = 0; m < hdelta; m++) {
-                    Particle *prtl = new Particle( (i - 1)*cll_sz + (k + 0.5)*delta, -1*cll_sz + (m + 0.5)*delta, 
+                    int prtl = store.AddWall( (i - 1)*cll_sz + (k + 0.5)*delta, -1*cll_sz + (m + 0.5)*delta, 
                                                    0.0, 0.0, cll_sz - (m + 0.5)*delta, 0.0, 1.0, hydro.materials[0]);
 
-                    prtl->cell_i = i; prtl->cell_j = 0; 
-                    //insert its poistion on the particle list
-                    hydro.particle_list.insert(hydro.particle_list.first(), prtl);
-
-                    //insert the position into corresponding cell list
-                    cell_lists[i][0].insert(cell_lists[i][0].first(), prtl);
+                    //put it into the corresponding cell
+                    AssignCell(prtl, i, 0);
 
                 }
         }
@@ -554,15 +889,11 @@ void ParticleManager::BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini,
             //creat a new wall particle
             for(k = 0; k < hdelta; k++)
                 for(m = 0; m < hdelta; m++) {
-                    Particle *prtl = new Particle( (i - 1)*cll_sz + (k + 0.5)*delta, (y_clls - 2)*cll_sz + (m + 0.5)*delta, 
+                    int prtl = store.AddWall( (i - 1)*cll_sz + (k + 0.5)*delta, (y_clls - 2)*cll_sz + (m + 0.5)*delta, 
                                                    0.0, 0.0, (m + 0.5)*delta, 0.0, 1.0, hydro.materials[0]);
 
-                    prtl->cell_i = i; prtl->cell_j = y_clls - 1; 
-                    //insert its poistion on the particle list
-                    hydro.particle_list.insert(hydro.particle_list.first(), prtl);
-
-                    //insert the position into corresponding cell list
-                    cell_lists[i][y_clls - 1].insert(cell_lists[i][y_clls - 1].first(), prtl);
+                    //put it into the corresponding cell
+                    AssignCell(prtl, i, y_clls - 1);
 
                 }
         }
@@ -570,6 +901,24 @@ void ParticleManager::BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini,
 }
 
 ParticleManager::~ParticleManager() {
-  for(int i = 0; i < x_clls; i++) delete [] cell_lists[i];
-  delete [] cell_lists;
+  delete [] cell_start;
+  delete [] particle_index;
+  delete [] cell_count;
+  delete [] verlet_org;
+  delete [] verlet_dest;
+  delete [] R_verlet;
+  delete [] verlet_colour_start;
+  delete [] verlet_colour;
+  delete [] sorted_org;
+  delete [] sorted_dest;
+  delete [] colour_mask;
+  delete [] colour_count;
+  for(int t = 0; t < number_of_buffers; t++) {
+    delete [] buffer_org[t];
+    delete [] buffer_dest[t];
+  }
+  delete [] buffer_org;
+  delete [] buffer_dest;
+  delete [] buffer_number;
+  delete [] buffer_capacity;
 }
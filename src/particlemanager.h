@@ -10,7 +10,6 @@ class Hydrodynamics;
 class Initiation;
 class QuinticSpline;
 class Boundary;
-class Particle;
 
 /// Particle manager class 
 class ParticleManager
@@ -28,18 +27,69 @@ class ParticleManager
     Vec2d U0; ///inital flow speed
     double rho0, p0, T0; ///initial particle mass and density, pressure and temperature
 
-    ///buid the initial wall particles and the linked lists
+    ///length of the particle_index array
+    int particle_index_length;
+    ///per-thread cell counters for the counting sort
+    int *cell_count;
+
+    ///Verlet pair list: candidate pairs within smoothinglength + skin
+    double skin; ///skin distance, 0: search the pairs at every time step
+    bool verlet_rebuild; ///the candidate pairs have to be searched again
+    int *verlet_org, *verlet_dest; ///candidate pairs
+    int verlet_number, verlet_capacity; ///number of candidate pairs and length of the arrays
+    Vec2d *R_verlet; ///real particle positions at the last pair search
+    int R_verlet_length; ///length of the R_verlet array
+
+    ///colouring of the candidate pairs for the parallel batches of the pair summations,
+    ///done once per pair search, the pairs kept by BuildInteraction() keep the colours
+    int pair_scatter; ///summation of the pair contributions, 0: serial, 1: coloured batches
+    int *verlet_colour_start; ///candidate pairs of colour c start at verlet_colour_start[c]
+    int *verlet_colour, *sorted_org, *sorted_dest; ///colour of each candidate pair and sort buffers
+    int colour_capacity; ///length of the verlet_colour and sort buffer arrays
+    unsigned long long *colour_mask; ///colours already used by each particle, one bit per colour
+    int colour_mask_length; ///length of the colour_mask array
+    int *colour_count; ///pairs of each colour kept by each thread
+
+    ///per-thread pair buffers, joined into one contiguous list after a parallel search
+    int number_of_buffers;
+    int **buffer_org, **buffer_dest; ///pairs found by each thread
+    int *buffer_number, *buffer_capacity; ///number of pairs in and length of each buffer
+
+    ///buid the initial wall particles and put them into cells
     void BiuldWallParticles(Hydrodynamics &hydro, Initiation &ini, Boundary &boundary);
+    ///buid the real particles from a binary restart file, false if it is not one
+    bool ReadBinaryRestart(Hydrodynamics &hydro, Initiation &ini, const char *inputfile);
+    ///cell index wrapped around the inner cells in a periodic direction
+    static int WrapCell(int i, int number_of_cells, double period) {
+        //not wrapped
+        if(period == 0.0) return i;
+        //the inner cells are 1 ... number_of_cells - 2
+        const int inner = number_of_cells - 2;
+        return (i - 1 + 2*inner) % inner + 1;
+    }
+    ///append a pair to a thread buffer if they are close and at least one is real
+    void AddVerletPair(int prtl_a, int prtl_b, double cutoffsquare, 
+                       int *&org, int *&dest, int &number, int &capacity);
+    ///search the candidate pairs in the cells
+    void BuildVerletList();
+    ///sort the candidate pairs into colours without common particles
+    void ColourVerletList();
 
 public:
 
-    ///linked cell matrix size
+    ///cell matrix size
     int x_clls, y_clls;
+    ///rings of surrounding cells searched for the candidate pairs and layers of cells
+    ///copied into the boundary particles, they cover the smoothing length plus the skin
+    int cell_rings;
 
-    ///lists
-    Llist<Particle> **cell_lists;       ///cell linked list in 2-d array
-        
-    Llist<Particle> NNP_list; ///list for the nearest neighbor particles
+    ///all particles
+    ParticleStore store;
+
+    ///cell grid built by a counting sort on store.cell_i and store.cell_j
+    ///the particles of cell (i, j) are particle_index[CellBegin(i, j)] ... particle_index[CellEnd(i, j) - 1]
+    int *cell_start; ///start of each cell in particle_index, x_clls*y_clls + 1 entries
+    int *particle_index; ///particle indices sorted by cell
 
     ///constructors
     ParticleManager();
@@ -49,20 +99,90 @@ public:
     /// destructor
     ~ParticleManager();
 
-    ///buid the initial particles and the linked lists
+    ///buid the initial particles and put them into cells
     void BiuldRealParticles(Hydrodynamics &hydro, Initiation &ini);
     void BiuldRealParticles(Hydrodynamics &hydro);
 
-    ///update the cell linked lists
-    void UpdateCellLinkedLists();
-    ///do NNP search around a point and biuld the NNP list
-    void BuildNNP(Vec2d &point);
-    ///do NNP search around a point and biuld the NNP list for MLS approximation
-    void BuildNNP_MLSMapping(Vec2d &point);
-    ///build the interaction (particle pair) list
-    void BuildInteraction(Llist<Interaction> &interactions, Llist<Particle> &particle_list, 
-                          Force **forces, QuinticSpline &weight_function, Initiation& ini);
+    ///range of cell (i, j) in particle_index
+    int CellBegin(int i, int j) const { return cell_start[i*y_clls + j]; }
+    int CellEnd(int i, int j) const { return cell_start[i*y_clls + j + 1]; }
+
+    ///put a particle into a cell, effective after the next SortParticles()
+    void AssignCell(int n, int i, int j);
+    ///put a real particle into the inner cell of its position
+    void AssignInnerCell(int n);
+    ///rebuild the cell grid from the cell positions of all particles
+    void SortParticles();
+    ///update the cell positions of the real particles
+    void UpdateCells();
+    ///call visit(n, r, r2) for each particle n closer than the smoothing length to a point,
+    ///r is the distance to the nearest image of the particle and r2 its square;
+    ///reentrant and without allocations, so it may be called by several threads
+    template<class Visitor> void ForNeighbours(const Vec2d &point, Visitor &visit) const;
+    ///call visit(p, n, r, r2) for each of the number points and each particle n closer 
+    ///than the smoothing length to points[p]; the points are searched in parallel, 
+    ///so visit may only change data of the point p
+    template<class Visitor> void ForNeighbours(int number, const Vec2d *points, Visitor &visit) const;
+    ///the particles in cell (k, m) and its surrounding cells, the candidates of ForNeighbours
+    ///for a point in cell (k, m) in the same order, into list of the length capacity, 
+    ///which grows if needed; returns the number of particles
+    int CellNeighbours(int k, int m, int *&list, int &capacity) const;
+    ///check the real particle displacements since the last pair search
+    ///true if the pairs and the boundary particles have to be rebuilt
+    bool CheckVerletList();
+    ///build the interaction (particle pair) list, without the pair values
+    void BuildInteraction(Interaction &interactions, 
+                          Force **forces, QuinticSpline &weight_function);
         
 };
 
+//----------------------------------------------------------------------------------------
+//                      the particles closer than the smoothing length to a point
+//----------------------------------------------------------------------------------------
+template<class Visitor> 
+void ParticleManager::ForNeighbours(const Vec2d &point, Visitor &visit) const
+{
+    //where is the point
+    const int k = int ((point[0] + cll_sz)/ cll_sz);
+    const int m = int ((point[1] + cll_sz)/ cll_sz);
+
+    //loop on this and all surrounding cells, wrapped around in the periodic directions
+    for(int s = k - 1; s <= k + 1; s++) {
+        for(int t = m - 1; t <= m + 1; t++) { 
+            const int i = WrapCell(s, x_clls, store.period[0]), j = WrapCell(t, y_clls, store.period[1]);
+            if(i < x_clls && j < y_clls && i >= 0 && j >= 0) {
+                //iterate this cell
+                for(int l = CellBegin(i, j); l < CellEnd(i, j); l++) {
+                    const int n = particle_index[l];
+                    const double r2 = v_sq(store.Wrap(point - store.R[n]));
+                    const double r = sqrt(r2);
+                    if(r < smoothinglength) visit(n, r, r2);
+                }
+            }
+        }
+    }
+}
+//----------------------------------------------------------------------------------------
+//                      the particles closer than the smoothing length to each point
+//----------------------------------------------------------------------------------------
+template<class Visitor> 
+void ParticleManager::ForNeighbours(int number, const Vec2d *points, Visitor &visit) const
+{
+    //the visitor of one point
+    struct PointVisitor {
+        Visitor &visit; 
+        int p;
+        PointVisitor(Visitor &visit, int p): visit(visit), p(p) {}
+        void operator()(int n, double r, double r2) { visit(p, n, r, r2); }
+    };
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for(int p = 0; p < number; p++) {
+        PointVisitor point_visit(visit, p);
+        ForNeighbours(points[p], point_visit);
+    }
+}
+
 #endif
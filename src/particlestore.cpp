@@ -0,0 +1,284 @@
+// particlestore.cpp
+// author: agent <agent@local>
+// changes by:
+
+//-------------------------------------------------------------------
+//                              Structure-of-arrays particle storage
+//                              particlestore.cpp
+//----------------------------------------------------------------
+
+// ***** system includes *****
+#include <cstring>
+
+// ***** local includes *****
+#include "glbcls.h"
+#include "glbfunc.h"
+#include "particlestore.h"
+#include "material.h"
+
+//----------------------------------------------------------------------------------------
+//                      grow an array and keep its first old_length elements
+//----------------------------------------------------------------------------------------
+template <class T> static void GrowArray(T *&a, int old_length, int new_length)
+{
+    T *b = new T[new_length];
+    for(int n = 0; n < old_length; n++) b[n] = a[n];
+    delete[] a;
+    a = b;
+}
+//----------------------------------------------------------------------------------------
+//                                                      constructor
+//----------------------------------------------------------------------------------------
+ParticleStore::ParticleStore(int number_of_materials) :
+    number_of_materials(number_of_materials), capacity(0),
+    number_of_real(0), number_of_particles(0), ID_max(0)
+{
+    period = 0.0;
+    cell_i = 0; cell_j = 0; mtl = 0; rl_prtl = 0;
+    R = 0; U = 0; rho = 0; p = 0; T = 0; Cs = 0; rho_I = 0;
+    m = 0; V = 0; e = 0; R_I = 0; U_I = 0; ShearRate_x = 0; ShearRate_y = 0;
+    eta = 0; zeta = 0; phi = 0; del_phi = 0; lap_phi = 0;
+    drhodt = 0; dedt = 0; dUdt = 0; _dU = 0;
+    bd = 0; bd_type = 0; ID = 0; polyID = 0; bd_dst = 0; nrml = 0;
+    Reserve(1024);
+}
+//----------------------------------------------------------------------------------------
+//                                                      destructor
+//----------------------------------------------------------------------------------------
+ParticleStore::~ParticleStore()
+{
+    delete[] cell_i; delete[] cell_j; delete[] mtl; delete[] rl_prtl;
+    delete[] R; delete[] U; delete[] rho; delete[] p; delete[] T; delete[] Cs; delete[] rho_I;
+    delete[] m; delete[] V; delete[] e; delete[] R_I; delete[] U_I;
+    delete[] ShearRate_x; delete[] ShearRate_y;
+    delete[] eta; delete[] zeta; delete[] phi; delete[] del_phi; delete[] lap_phi;
+    delete[] drhodt; delete[] dedt; delete[] dUdt; delete[] _dU;
+    delete[] bd; delete[] bd_type; delete[] ID; delete[] polyID; delete[] bd_dst; delete[] nrml;
+}
+//----------------------------------------------------------------------------------------
+//                              grow all arrays to hold at least n particles
+//----------------------------------------------------------------------------------------
+void ParticleStore::Reserve(int n)
+{
+    if(n <= capacity) return;
+
+    int new_capacity = capacity > 0 ? capacity : 1024;
+    while(new_capacity < n) new_capacity *= 2;
+    const int nm2 = number_of_materials*number_of_materials;
+    const int old = number_of_particles;
+
+    GrowArray(cell_i, old, new_capacity); GrowArray(cell_j, old, new_capacity);
+    GrowArray(mtl, old, new_capacity); GrowArray(rl_prtl, old, new_capacity);
+    GrowArray(R, old, new_capacity); GrowArray(U, old, new_capacity);
+    GrowArray(rho, old, new_capacity); GrowArray(p, old, new_capacity);
+    GrowArray(T, old, new_capacity); GrowArray(Cs, old, new_capacity);
+    GrowArray(rho_I, old, new_capacity);
+    GrowArray(m, old, new_capacity); GrowArray(V, old, new_capacity); GrowArray(e, old, new_capacity);
+    GrowArray(R_I, old, new_capacity); GrowArray(U_I, old, new_capacity);
+    GrowArray(ShearRate_x, old, new_capacity); GrowArray(ShearRate_y, old, new_capacity);
+    GrowArray(eta, old, new_capacity); GrowArray(zeta, old, new_capacity);
+    GrowArray(phi, old*nm2, new_capacity*nm2);
+    GrowArray(lap_phi, old*nm2, new_capacity*nm2);
+    GrowArray(del_phi, old, new_capacity);
+    GrowArray(drhodt, old, new_capacity); GrowArray(dedt, old, new_capacity);
+    GrowArray(dUdt, old, new_capacity); GrowArray(_dU, old, new_capacity);
+    GrowArray(bd, old, new_capacity); GrowArray(bd_type, old, new_capacity);
+    GrowArray(ID, old, new_capacity); GrowArray(polyID, old, new_capacity);
+    GrowArray(bd_dst, old, new_capacity); GrowArray(nrml, old, new_capacity);
+
+    capacity = new_capacity;
+}
+//----------------------------------------------------------------------------------------
+//                              append an empty particle and return its index
+//----------------------------------------------------------------------------------------
+int ParticleStore::Append()
+{
+    Reserve(number_of_particles + 1);
+    const int n = number_of_particles++;
+    const int nm2 = number_of_materials*number_of_materials;
+
+    cell_i[n] = 0; cell_j[n] = 0; mtl[n] = 0; rl_prtl[n] = -1;
+    R[n] = 0.0; U[n] = 0.0; R_I[n] = 0.0; U_I[n] = 0.0;
+    rho[n] = 0.0; p[n] = 0.0; T[n] = 0.0; Cs[n] = 0.0; rho_I[n] = 0.0;
+    m[n] = 0.0; V[n] = 0.0; e[n] = 0.0;
+    ShearRate_x[n] = 0.0; ShearRate_y[n] = 0.0;
+    eta[n] = 0.0; zeta[n] = 0.0; del_phi[n] = 0.0;
+    for(int k = 0; k < nm2; k++) {
+        phi[n*nm2 + k] = 0.0;
+        lap_phi[n*nm2 + k] = 0.0;
+    }
+    drhodt[n] = 0.0; dedt[n] = 0.0; dUdt[n] = 0.0; _dU[n] = 0.0;
+    bd[n] = 0; bd_type[n] = 0; ID[n] = 0; polyID[n] = 0;
+    bd_dst[n] = 0.0; nrml[n] = 0.0;
+    return n;
+}
+//----------------------------------------------------------------------------------------
+//                                                      real particle
+//              NOTE the particle mass and volume will be specified initiation::VolumeMass()
+//----------------------------------------------------------------------------------------
+int ParticleStore::AddReal(Vec2d position, Vec2d velocity, double density, double pressure,
+                           double temperature, Material &material)
+{
+    const int n = Append();
+    //real particles are kept before all boundary particles
+    number_of_real = number_of_particles;
+
+    //give a new ID number
+    ID_max++;
+    ID[n] = ID_max;
+    bd[n] = 0;
+
+    //point to the material properties
+    mtl[n] = &material;
+    //viscosity
+    eta[n] = material.eta; zeta[n] = material.zeta;
+
+    //set particle position
+    R[n] = position;
+
+    //set states
+    rho[n] = density; p[n] = pressure; T[n] = temperature; Cs[n] = material.get_Cs(pressure, density);
+    U[n] = velocity; U_I[n] = velocity;
+
+    //set conservative values and their  intermediate values
+    m[n] = 0.0; V[n] = 0.0; e[n] = material.get_e(temperature);
+    R_I[n] = position; rho_I[n] = density;
+    return n;
+}
+//----------------------------------------------------------------------------------------
+//                                                              add a wall particle
+//----------------------------------------------------------------------------------------
+int ParticleStore::AddWall(double x, double y, double u, double v,
+                           double distance, double normal_x, double normal_y, Material &material)
+{
+    const int n = Append();
+    //wall particles never move and are kept with the real particles
+    number_of_real = number_of_particles;
+
+    bd[n] = 1; bd_type[n] = 0;
+    ID[n] = 0;
+
+    //point to the material properties
+    mtl[n] = &material;
+
+    //set particle position and states
+    R[n][0] = x; R[n][1] = y;
+    U[n][0] = u; U[n][1] = v;
+
+    //distance and normal directions to boundary
+    bd_dst[n] = distance;
+    nrml[n][0] = normal_x; nrml[n][1] = normal_y;
+    return n;
+}
+//----------------------------------------------------------------------------------------
+//                      take the next boundary slot and copy a particle into it
+//              every field is written, so nothing is left from the last time step
+//----------------------------------------------------------------------------------------
+int ParticleStore::BoundarySlot(int real, bool copy_phase)
+{
+    Reserve(number_of_particles + 1);
+    const int n = number_of_particles++;
+    const int nm2 = number_of_materials*number_of_materials;
+
+    //point to its real particle
+    rl_prtl[n] = real; cell_i[n] = 0; cell_j[n] = 0;
+    bd[n] = 1; ID[n] = 0;
+
+    //set states
+    R[n] = R[real]; rho[n] = rho[real]; p[n] = p[real]; T[n] = T[real];
+    Cs[n] = Cs[real]; U[n] = U[real]; U_I[n] = U_I[real];
+    ShearRate_x[n] = ShearRate_x[real]; ShearRate_y[n] = ShearRate_y[real];
+
+    //set conservative values and their intermediate values
+    m[n] = m[real]; V[n] = V[real]; e[n] = e[real];
+    R_I[n] = R_I[real]; rho_I[n] = rho[real];
+
+    //phase field
+    const double *phi_r = Phi(real), *lap_phi_r = LapPhi(real);
+    double *phi_n = Phi(n), *lap_phi_n = LapPhi(n);
+    for(int k = 0; k < nm2; k++) {
+        phi_n[k] = copy_phase ? phi_r[k] : 0.0;
+        lap_phi_n[k] = copy_phase ? lap_phi_r[k] : 0.0;
+    }
+    del_phi[n] = copy_phase ? del_phi[real] : 0.0;
+
+    //change rates and wall geometry are not used for boundary particles
+    drhodt[n] = 0.0; dedt[n] = 0.0; dUdt[n] = 0.0; _dU[n] = 0.0;
+    bd_dst[n] = 0.0; nrml[n] = 0.0;
+    return n;
+}
+//----------------------------------------------------------------------------------------
+//                                              add a ghost particle
+//----------------------------------------------------------------------------------------
+int ParticleStore::AddGhost(int real)
+{
+    const int n = BoundarySlot(real, true);
+
+    bd_type[n] = 1;
+    //give a ghost particle the same polyID as a real particle
+    polyID[n] = polyID[real];
+
+    //point to the material properties
+    mtl[n] = mtl[real];
+    //viscosity
+    eta[n] = mtl[n]->eta; zeta[n] = mtl[n]->zeta;
+    return n;
+}
+//----------------------------------------------------------------------------------------
+//                                                      add an image particle
+//----------------------------------------------------------------------------------------
+int ParticleStore::AddImage(int real, Material &material)
+{
+    const int n = BoundarySlot(real, false);
+
+    bd_type[n] = 0;
+    //give an image particle zero polyID
+    polyID[n] = 0;
+
+    //point to the material properties
+    mtl[n] = &material;
+    //viscosity
+    eta[n] = eta[real]; zeta[n] = zeta[real];
+    return n;
+}
+//----------------------------------------------------------------------------------------
+//                                              drop all boundary particles
+//----------------------------------------------------------------------------------------
+void ParticleStore::ClearBoundary()
+{
+    number_of_particles = number_of_real;
+}
+//----------------------------------------------------------------------------------------
+//                                      particle states copier for boundary particles
+//----------------------------------------------------------------------------------------
+void ParticleStore::StatesCopier(int n, int type, int fields)
+{
+    const int r = rl_prtl[n];
+    int i;
+
+    //copy states
+    if(fields & POSITION) R[n] = R[r];
+    if(fields & VELOCITY) { U[n] = U[r]; U_I[n] = U_I[r]; }
+    if(fields & DENSITY) { rho[n] = rho[r]; rho_I[n] = rho_I[r]; p[n] = p[r]; }
+    if(fields & PROPERTIES) { m[n] = m[r]; V[n] = V[r]; T[n] = T[r]; Cs[n] = Cs[r]; }
+    if(fields & SHEAR_RATE) { ShearRate_x[n] = ShearRate_x[r]; ShearRate_y[n] = ShearRate_y[r]; }
+
+    double *phi_n = Phi(n), *phi_r = Phi(r);
+    //perodic boundary
+    if (type == 1 ) {
+        if(fields & PHASE_GRADIENT) del_phi[n] = del_phi[r];
+        if(fields & PHASE_FIELD) {
+            double *lap_phi_n = LapPhi(n), *lap_phi_r = LapPhi(r);
+            for(i = 0; i < number_of_materials*number_of_materials; i++) {
+                phi_n[i] = phi_r[i];
+                lap_phi_n[i] = lap_phi_r[i];
+            }
+        }
+    }
+
+    //wall boundary
+    if (type == 0 && (fields & PHASE_FIELD)) {
+        phi_n[0] = 0.0;
+        for(i = 1; i < number_of_materials; i++) phi_n[0] += phi_r[i*number_of_materials + i];
+    }
+}
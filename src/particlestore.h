@@ -0,0 +1,144 @@
+/// \file particlestore.h
+/// \brief Structure-of-arrays storage for all sph particles
+
+#ifndef PARTICLESTORE_H
+#define PARTICLESTORE_H
+
+class Material;
+
+///note: a particle is referenced by its dense index in the store
+///never keep a pointer into the arrays, they move when the store grows!
+
+/// Structure-of-arrays particle storage
+///
+/// The real (and wall) particles occupy the indices [0, number_of_real),
+/// the boundary particles, which are rebuilt at every time step,
+/// occupy the indices [number_of_real, number_of_particles).
+/// The boundary slots are kept when the boundary particles are dropped
+/// and are refreshed in place when they are rebuilt.
+class ParticleStore {
+
+    int number_of_materials;
+    ///length of the allocated arrays
+    int capacity;
+
+    ///grow all arrays to hold at least n particles
+    void Reserve(int n);
+    ///append an empty particle and return its index
+    int Append();
+    ///take the next boundary slot and fill it with the states of a particle,
+    ///the phase field is copied or cleared
+    int BoundarySlot(int real, bool copy_phase);
+
+public:
+
+    ///number of real and wall particles
+    int number_of_real;
+    ///number of all particles including the boundary particles
+    int number_of_particles;
+
+    ///position in cells
+    int *cell_i, *cell_j;
+
+    ///point to the material
+    Material **mtl;
+
+    ///index of the particle a boundary particle is copied from
+    int *rl_prtl;
+
+    ///Physical data
+    Vec2d *R, *U; ///position, velocity
+    double *rho, *p, *T, *Cs, *rho_I; ///density, pressure, temperature, sound speed
+    double *m, *V, *e; ///mass, volume, internal energy
+    Vec2d *R_I, *U_I; ///intermediate position and velocity used in integrator
+    Vec2d *ShearRate_x, *ShearRate_y;
+
+    ///for multimaterials
+    double *eta, *zeta; ///viscosity of each particle
+    ///phase field matrix, number_of_materials x number_of_materials for each particle
+    double *phi;
+    ///first as phase field gradient matrix
+    ///then the independent values ([0][0] and [0][1]) of suface stress matrix
+    Vec2d *del_phi;
+    double *lap_phi;
+
+    ///change rate for real particles
+    double *drhodt, *dedt; ///density and internal energy
+    Vec2d *dUdt, *_dU; ///acceration and random velocity change
+
+    ///0: inside the boundary
+    ///1: on the boundary
+    int *bd; ///boundary particle or not
+
+    ///boundary type when bd = 1
+    ///0 wall particle with zero or constant velocity but never move its position
+    ///1 ghost particle for perodic boundary
+    int *bd_type;
+
+    ///ID number
+    ///a real particle has a unique positive ID
+    ///a wall and a boundary particle have zero ID
+    long *ID;
+
+    /// polymer ID number (used to connect SDPD particles with a FENE force)
+    long *polyID;
+
+    ///for wall boundary particles
+    double *bd_dst;
+    Vec2d *nrml;
+
+    ///maximum ID number for non-ghost particles (real or wall particles) in the simulation
+    long ID_max;
+
+    ///length of the periodic directions which are wrapped by the nearest image
+    ///instead of ghost particles, 0: not wrapped
+    Vec2d period;
+
+    ///constructor
+    explicit ParticleStore(int number_of_materials);
+    ///destructor
+    ~ParticleStore();
+
+    ///phase field matrices of a particle
+    double *Phi(int n) const { return phi + n*number_of_materials*number_of_materials; }
+    double *LapPhi(int n) const { return lap_phi + n*number_of_materials*number_of_materials; }
+
+    ///nearest image of a distance vector in the wrapped directions
+    Vec2d Wrap(Vec2d d) const {
+        for(int i = 0; i < 2; i++) 
+            if(period[i] > 0.0) d[i] -= period[i]*floor(d[i]/period[i] + 0.5);
+        return d;
+    }
+    ///vector from particle b to particle a between their nearest images
+    Vec2d Separation(int a, int b) const { return Wrap(R[a] - R[b]); }
+    ///position of the image of particle n nearest to a point
+    Vec2d Image(int n, const Vec2d &point) const {
+        Vec2d r = R[n];
+        for(int i = 0; i < 2; i++) 
+            if(period[i] > 0.0) r[i] += period[i]*floor((point[i] - r[i])/period[i] + 0.5);
+        return r;
+    }
+
+    ///add a real particle
+    ///NOTE the particle mass and volume will be specified initiation::VolumeMass()
+    int AddReal(Vec2d position, Vec2d velocity, double density, double pressure, double temperature,
+                Material &material);
+    ///add a wall particle
+    int AddWall(double x, double y, double u, double v,
+                double distance, double normal_x, double normal_y, Material &material);
+    ///add a ghost particle of a particle
+    int AddGhost(int real);
+    ///add a mirror image particle of a particle
+    int AddImage(int real, Material &material);
+
+    ///drop all boundary particles, their slots are reused
+    void ClearBoundary();
+
+    ///states copied to the boundary particles
+    enum States { POSITION = 1, VELOCITY = 2, DENSITY = 4, SHEAR_RATE = 8, PHASE_FIELD = 16, 
+                  PHASE_GRADIENT = 32, PROPERTIES = 64, ALL_STATES = 127 };
+    ///particle states copier for boundary particles, only the states given by fields are copied
+    void StatesCopier(int n, int type, int fields = ALL_STATES);
+};
+
+#endif
@@ -27,6 +27,23 @@ public:
     ///Calculates the kernel Laplacian. 
     double LapW(const double distance) const;
 
+    ///Calculates w, F divided by the distance and LapW at once.
+    ///The three parts of the spline are selected without branching on the distance.
+    void Values(const double distance, double &w, double &F_r, double &lapW) const
+    {
+        // dist/smoothingLength is often needed
+        const double normedDist = 3.0*distance * reciprocH;
+        // the three parts of the spline, each zero outside of its region
+        const double ss3 = normedDist < 3.0 ? 3.0 - normedDist : 0.0;
+        const double ss2 = normedDist < 2.0 ? 2.0 - normedDist : 0.0;
+        const double ss1 = normedDist < 1.0 ? 1.0 - normedDist : 0.0;
+
+        w = factorW * (ss3*ss3*ss3*ss3*ss3 - 6.0*ss2*ss2*ss2*ss2*ss2 + 15.0*ss1*ss1*ss1*ss1*ss1);
+        F_r = factorGradW * (ss3*ss3*ss3*ss3 - 6.0*ss2*ss2*ss2*ss2 + 15.0*ss1*ss1*ss1*ss1)
+            * (1.0/(distance + 1.0e-30));
+        lapW = factorLapW * (ss3*ss3*ss3 - 6.0*ss2*ss2*ss2 + 15.0*ss1*ss1*ss1);
+    }
+
 private:
     ///Normalization factor
     const double norm;
@@ -0,0 +1,54 @@
+/// \file restartfile.h
+/// \brief Layout of the binary restart file
+
+#ifndef RESTARTFILE_H
+#define RESTARTFILE_H
+
+/// Binary restart file
+///
+/// The file is the header, the material table and one raw little-endian array
+/// per particle field, in this order:
+/// R, U (2 doubles per particle), rho, p, T (double), polyID, ID (64 bit integer)
+/// and the material number (32 bit integer) of the real particles.
+/// The material table gives the material name of each material number,
+/// RESTART_NAME_LENGTH characters each.
+/// All sections start at a multiple of 8 bytes, so the arrays can be used
+/// directly from a memory map of the file.
+struct RestartHeader {
+    char magic[8];              ///RESTART_MAGIC
+    int version;                ///RESTART_VERSION
+    int number_of_materials;    ///entries of the material table
+    long long number_of_particles; ///number of real particles
+    double time;                ///non-dimensional time of the restart
+    long long random_step;      ///counter of the Wiener increments
+    long long random_seed;      ///seed of the Wiener increments
+};
+
+#define RESTART_MAGIC "SPH-RST"
+enum { RESTART_VERSION = 1, RESTART_NAME_LENGTH = 32 };
+
+///offsets of the sections of a restart file
+struct RestartLayout {
+    long long materials, R, U, rho, p, T, polyID, ID, material, size;
+
+    RestartLayout(int number_of_materials, long long n) {
+        materials = sizeof(RestartHeader);
+        R = materials + ((number_of_materials*RESTART_NAME_LENGTH + 7)/8)*8;
+        U = R + 16*n;
+        rho = U + 16*n;
+        p = rho + 8*n;
+        T = p + 8*n;
+        polyID = T + 8*n;
+        ID = polyID + 8*n;
+        material = ID + 8*n;
+        size = material + 4*n;
+    }
+};
+
+///true if the machine stores numbers little-endian as the restart file
+inline bool RestartByteOrder() {
+    const int one = 1;
+    return *(const char *)&one == 1;
+}
+
+#endif
@@ -76,8 +76,8 @@ To run a SDPD solvent case
 #include "glbfunc.h"
 #include "glbcls.h"
 #include "initiation.h"
-#include "particle.h"
 #include "interaction.h"
+#include "bondlist.h"
 #include "quinticspline.h"
 #include "mls.h"
 #include "particlemanager.h"
@@ -118,16 +118,15 @@ int main(int argc, char *argv[]) {
         
     //initializatioinins
     Initiation ini(argv[1]); //global initialization
-
-    //a sample particle and interaction for static numbers
-    Particle sample(ini);
-    Interaction interaction(ini);
+    //the machine random seed, from the .cfg file or from the clock
+    srand(ini.random_seed != 0 ? (unsigned)ini.random_seed : (unsigned)time(NULL));
 
     QuinticSpline weight_function(ini.smoothinglength); //initiate the weight function
     MLS mls(ini); //initiate the Moving Least Squares approximation
     ParticleManager particles(ini); //initiate the particle manager
     Hydrodynamics hydro(particles, ini); //create materials, forces and real particles
     Boundary boundary(ini, hydro, particles); //initiate boundary conditions and boundary particles
+    hydro.BuildBonds(boundary); //the FENE bonds between the polymer beads
     TimeSolver timesolver(ini); //initialize the time solver
     Output output(ini); //output class should be the last one being initialized
     ini.VolumeMass(hydro, particles, weight_function); //predict particle volume and mass
@@ -140,8 +139,9 @@ int main(int argc, char *argv[]) {
     //output initial conditions
     output.OutputParticles(hydro, boundary, Time, ini); //particle positions and velocites
     output.OutputStates(particles, mls, weight_function, Time, ini); //initial states on uniform grid
-    output.CreatParticleMovie(); //the particle moive file head
+    output.CreatParticleMovie(hydro); //the particle moive file head
     output.WriteParticleMovie(hydro, Time, ini); //the first frame of the movie
+    output.SubmitOutput(); //written in the background
     //output diagnose information
     if(ini.diagnose == 2 ) diagnose.KineticInformation(Time, ini, hydro);
 
@@ -151,14 +151,12 @@ int main(int argc, char *argv[]) {
         // adjust the last D_time
         if(Time + ini.D_time >=  ini.End_time) ini.D_time = ini.End_time - Time; 
                 
-        //set the machine random seed
-        srand( (unsigned)time( NULL ) );
+        //set the machine random seed, unless the results have to be reproducible
+        if(ini.random_seed == 0) srand( (unsigned)time( NULL ) );
                 
-        //call the time slover
-//              timesolver.TimeIntegral(hydro, particles, boundary, Time, 
-//                      ini.D_time, diagnose, ini, weight_function, mls);
-        timesolver.TimeIntegral_summation(hydro, particles, boundary, Time, 
-                                          ini.D_time, diagnose, ini, weight_function, mls);
+        //call the time slover chosen in the .cfg file
+        timesolver.Integrate(hydro, particles, boundary, Time, 
+                             ini.D_time, diagnose, ini, weight_function, mls);
                 
         //output results after a time interval
         output.OutputParticles(hydro, boundary, Time, ini); //particle positions and velocites
@@ -166,12 +164,14 @@ int main(int argc, char *argv[]) {
 //              output.OutAverage(particles, mls, weight_function, Time, ini);
         output.WriteParticleMovie(hydro, Time, ini); //a frame of the particle movie
         output.OutRestart(hydro, Time, ini); //restarting file
+        output.SubmitOutput(); //written in the background while the computation goes on
 
         //output diagnose information
         if(ini.diagnose == 1) {
             diagnose.OutputProfile(Time, ini);
             diagnose.OutputAverage(Time, ini);  
         }
+        if(ini.correlation_interval > 0.0) diagnose.OutputCorrelation(Time);
     }
 
     cout << time(NULL) - bm_start_time << " seconds.\n";
@@ -19,6 +19,8 @@
 #include "glbcls.h"
 #include "glbfunc.h"
 #include "timesolver.h"
+#include "interaction.h"
+#include "bondlist.h"
 #include "hydrodynamics.h"
 #include "boundary.h"
 #include "particlemanager.h"
@@ -41,6 +43,26 @@ TimeSolver::TimeSolver(Initiation &ini)
         
     //initialize the iteration
     ite = 0;
+    verlet_rates = false;
+}
+//----------------------------------------------------------------------------------------
+//                              advance time interval D_time 
+//                              with the integrator chosen in the .cfg file
+//----------------------------------------------------------------------------------------
+void TimeSolver::Integrate(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
+                           double &Time, double D_time, Diagnose &diagnose,
+                           Initiation &ini, QuinticSpline &weight_function, MLS &mls)
+{
+    switch(ini.integrator) {
+    case 1:
+        TimeIntegral(hydro, particles, boundary, Time, D_time, diagnose, ini, weight_function, mls);
+        break;
+    case 2:
+        TimeIntegral_verlet(hydro, particles, boundary, Time, D_time, diagnose, ini, weight_function, mls);
+        break;
+    default:
+        TimeIntegral_summation(hydro, particles, boundary, Time, D_time, diagnose, ini, weight_function, mls);
+    }
 }
 //----------------------------------------------------------------------------------------
 //                                              advance time interval D_time
@@ -51,7 +73,7 @@ void TimeSolver::TimeIntegral(Hydrodynamics &hydro, ParticleManager &particles,
                               Initiation &ini, QuinticSpline &weight_function, MLS &mls)
 {
     double integeral_time = 0.0;
-        
+
     while(integeral_time < D_time) {
 
         dt = hydro.GetTimestep();
@@ -66,7 +88,7 @@ void TimeSolver::TimeIntegral(Hydrodynamics &hydro, ParticleManager &particles,
 
         //calculating diagonse information
         if(ini.diagnose == 1) {
-            diagnose.SaveStates(hydro);
+            diagnose.SaveStates(Time, hydro);
             diagnose.Average(particles, mls, weight_function, ini);
         }
         if(ini.diagnose == 2 && ite % 10 == 0) 
@@ -74,17 +96,19 @@ void TimeSolver::TimeIntegral(Hydrodynamics &hydro, ParticleManager &particles,
 
         //predictor and corrector method used
         //the prediction step
-        hydro.BuildPair(particles, weight_function);
+        //the pair values and the forces are computed in one sweep
 //              hydro.UpdatePhaseGradient(boundary);
 //              hydro.UpdateSurfaceStress(boundary);
 //              boundary.BoundaryCondition(particles);
 
-        hydro.UpdateChangeRate();
+        hydro.UpdateChangeRate(particles, weight_function);
+        //the stress sample with the pairs and the forces of the states at the start of the step
+        if(ini.correlation_interval > 0.0) diagnose.Correlation(Time - dt, hydro);
         hydro.Predictor(dt);
         hydro.UpdateState();
 
         //the correction step without update the interaction list
-        hydro.UpdatePair(weight_function);
+        hydro.UpdatePair();
         boundary.BoundaryCondition(particles);
 //              hydro.UpdatePhaseGradient(boundary);
 //              hydro.UpdateSurfaceStress(boundary);
@@ -98,8 +122,13 @@ void TimeSolver::TimeIntegral(Hydrodynamics &hydro, ParticleManager &particles,
 
         //renew boundary particles
         boundary.RunAwayCheck(hydro);
-        particles.UpdateCellLinkedLists();
-        boundary.BuildBoundaryParticles(particles, hydro);
+        particles.UpdateCells();
+        if(particles.CheckVerletList()) boundary.BuildBoundaryParticles(particles, hydro);
+        else {
+            //keep the boundary particles as long as the Verlet pair list is valid
+            particles.SortParticles();
+            boundary.BoundaryCondition(particles);
+        }
     }
 }
 //----------------------------------------------------------------------------------------
@@ -127,7 +156,7 @@ void TimeSolver::TimeIntegral_summation(Hydrodynamics &hydro, ParticleManager &p
 
         //calculating diagonse information
         if(ini.diagnose == 1) {
-            diagnose.SaveStates(hydro);
+            diagnose.SaveStates(Time, hydro);
             diagnose.Average(particles, mls, weight_function, ini);
         }
 
@@ -135,33 +164,116 @@ void TimeSolver::TimeIntegral_summation(Hydrodynamics &hydro, ParticleManager &p
         if(ini.diagnose == 2 && ite % 10 == 0) diagnose.KineticInformation(Time, ini, hydro);
         //predictor and corrector method used
         //the prediction step
-        hydro.BuildPair(particles, weight_function);
-        hydro.UpdateDensity();
-        boundary.BoundaryCondition(particles);
+        //the pair values and the density are computed in one sweep
+        //only the states changed since the last boundary condition are copied
+        hydro.UpdateDensity(particles, weight_function);
+        boundary.BoundaryCondition(particles, ParticleStore::DENSITY);
         hydro.UpdatePhaseGradient(boundary);
-        boundary.BoundaryCondition(particles);
+        boundary.BoundaryCondition(particles, ParticleStore::PHASE_GRADIENT);
         hydro.UpdateSurfaceStress(boundary);
         hydro.UpdateChangeRate();
+        //the stress sample with the pairs and the forces of the states at the start of the step
+        if(ini.correlation_interval > 0.0) diagnose.Correlation(Time - dt, hydro);
         hydro.Predictor_summation(dt);
 
         //the correction step without update the interaction list
-        boundary.BoundaryCondition(particles);
-        hydro.UpdatePair(weight_function);
-        hydro.UpdateDensity();
-        boundary.BoundaryCondition(particles);
+        boundary.BoundaryCondition(particles, ParticleStore::POSITION | ParticleStore::VELOCITY);
+        hydro.UpdatePairDensity();
+        boundary.BoundaryCondition(particles, ParticleStore::DENSITY);
         hydro.UpdatePhaseGradient(boundary);
-        boundary.BoundaryCondition(particles);
+        boundary.BoundaryCondition(particles, ParticleStore::PHASE_GRADIENT);
         hydro.UpdateSurfaceStress(boundary);
         hydro.UpdateChangeRate(); 
 	hydro.UpdateRandom(sqrt(dt));
-        hydro.Corrector_summation(dt);
+        //the FENE bonds in sub steps with the pair forces at n+1/2
+        if(ini.respa_steps > 1) hydro.Corrector_respa(dt);
+        else hydro.Corrector_summation(dt);
 	hydro.RandomEffects();
 
         //renew boundary particles
         boundary.RunAwayCheck(hydro);
-        particles.UpdateCellLinkedLists();
-        boundary.BuildBoundaryParticles(particles, hydro);
+        particles.UpdateCells();
+        if(particles.CheckVerletList()) boundary.BuildBoundaryParticles(particles, hydro);
+        else {
+            //keep the boundary particles as long as the Verlet pair list is valid
+            particles.SortParticles();
+            boundary.BoundaryCondition(particles, ParticleStore::POSITION | ParticleStore::VELOCITY);
+        }
     }
 }
+//----------------------------------------------------------------------------------------
+//                      density, phase field and change rates at the current positions
+//                      with a new pair list
+//----------------------------------------------------------------------------------------
+void TimeSolver::ChangeRate_summation(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
+                                      QuinticSpline &weight_function)
+{
+    //the pair values and the density are computed in one sweep
+    hydro.UpdateDensity(particles, weight_function);
+    boundary.BoundaryCondition(particles, ParticleStore::DENSITY);
+    hydro.UpdatePhaseGradient(boundary);
+    boundary.BoundaryCondition(particles, ParticleStore::PHASE_GRADIENT);
+    hydro.UpdateSurfaceStress(boundary);
+    hydro.UpdateChangeRate();
+}
+//----------------------------------------------------------------------------------------
+//                                      advance time interval D_time with summation for density
+//                                      velocity Verlet (Groot-Warren, lambda = 1/2) used,
+//                                      the change rates are evaluated once per time step
+//----------------------------------------------------------------------------------------
+void TimeSolver::TimeIntegral_verlet(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
+                                     double &Time, double D_time, Diagnose &diagnose,
+                                     Initiation &ini, QuinticSpline &weight_function, MLS &mls)
+{
+    double integeral_time = 0.0;
 
+    //the change rates at the initial positions
+    if(!verlet_rates) {
+        ChangeRate_summation(hydro, particles, boundary, weight_function);
+        verlet_rates = true;
+    }
+        
+    while(integeral_time < D_time) {
 
+        dt = hydro.GetTimestep();
+
+        ite ++;
+        integeral_time += dt;
+        Time += dt;
+                
+        //screen information for the iteration
+        if(ite % 10 == 0) cout<<"N="<<ite<<" Time: "
+                              <<Time<<"   dt: "<<dt 
+                              << "   max_time: " <<ini.End_time << std::endl;
+
+        //calculating diagonse information
+        if(ini.diagnose == 1) {
+            diagnose.SaveStates(Time, hydro);
+            diagnose.Average(particles, mls, weight_function, ini);
+        }
+
+        //output diagnose information
+        if(ini.diagnose == 2 && ite % 10 == 0) diagnose.KineticInformation(Time, ini, hydro);
+
+        //half step of the velocity and the new positions
+        hydro.VerletDrift(dt);
+
+        //renew boundary particles
+        boundary.RunAwayCheck(hydro);
+        particles.UpdateCells();
+        if(particles.CheckVerletList()) boundary.BuildBoundaryParticles(particles, hydro);
+        else {
+            //keep the boundary particles as long as the Verlet pair list is valid
+            particles.SortParticles();
+            boundary.BoundaryCondition(particles, ParticleStore::POSITION | ParticleStore::VELOCITY);
+        }
+
+        //the only evaluation of the change rates in this time step
+        ChangeRate_summation(hydro, particles, boundary, weight_function);
+        //the stress sample with the pairs and the forces of the new positions
+        if(ini.correlation_interval > 0.0) diagnose.Correlation(Time, hydro);
+        hydro.VerletKick(dt);
+        hydro.UpdateRandom(sqrt(dt));
+        hydro.RandomEffects();
+    }
+}
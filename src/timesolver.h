@@ -22,6 +22,12 @@ class TimeSolver{
 
     int ite; ///number of itenary
     double dt; ///time step
+    ///the change rates at the current step are known for velocity Verlet
+    bool verlet_rates;
+
+    ///density, phase field and change rates with a new pair list at the current positions
+    void ChangeRate_summation(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
+                              QuinticSpline &weight_function);
 
 public:
         
@@ -36,6 +42,15 @@ public:
     void TimeIntegral_summation(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
                                 double &Time, double D_time, Diagnose &diagnose,
                                 Initiation &ini, QuinticSpline &weight_function, MLS &mls);
+    ///advance time interval D_time with summation for density and velocity Verlet,
+    ///one evaluation of the change rates per time step
+    void TimeIntegral_verlet(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
+                             double &Time, double D_time, Diagnose &diagnose,
+                             Initiation &ini, QuinticSpline &weight_function, MLS &mls);
+    ///advance time interval D_time with the integrator chosen in the .cfg file
+    void Integrate(Hydrodynamics &hydro, ParticleManager &particles, Boundary &boundary,
+                   double &Time, double D_time, Diagnose &diagnose,
+                   Initiation &ini, QuinticSpline &weight_function, MLS &mls);
 
 };
 
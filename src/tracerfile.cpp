@@ -0,0 +1,105 @@
+// tracerfile.cpp
+// author: agent <agent@local>
+// changes by:
+
+//----------------------------------------------------------------------------------------
+//              Binary trajectories of tracer particles
+//              tracerfile.cpp
+//----------------------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+
+#include <cstdlib>
+#include <cstring>
+
+// ***** localincludes *****
+#include "glbcls.h"
+#include "tracerfile.h"
+#include "restartfile.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+//                                      constructor
+//----------------------------------------------------------------------------------------
+TracerRecorder::TracerRecorder():
+number_of_tracers(0), record_length(0), buffer(0), number_of_records(0)
+{
+}
+//----------------------------------------------------------------------------------------
+//                                      destructor
+//----------------------------------------------------------------------------------------
+TracerRecorder::~TracerRecorder()
+{
+    Flush();
+    if(file.is_open()) file.close();
+    delete[] buffer;
+}
+//----------------------------------------------------------------------------------------
+//                              create the file for the tracers
+//----------------------------------------------------------------------------------------
+void TracerRecorder::Create(const char *file_name, int number_of_tracers, const long *ID)
+{
+    if(!RestartByteOrder()) {
+        cout<<"TracerRecorder: the tracer file needs a little-endian machine \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+
+    this->number_of_tracers = number_of_tracers;
+    record_length = 1 + TRACER_STATES*number_of_tracers;
+    delete[] buffer;
+    buffer = new double[TRACER_BUFFER*record_length];
+    number_of_records = 0;
+
+    TracerHeader header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, TRACER_MAGIC);
+    header.version = TRACER_VERSION;
+    header.number_of_tracers = number_of_tracers;
+    header.number_of_states = TRACER_STATES;
+
+    if(file.is_open()) file.close();
+    file.open(file_name, ios::out | ios::binary | ios::trunc);
+    if(!file) {
+        cout<<"TracerRecorder: Cannot create "<< file_name <<" \n";
+        std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+        exit(1);
+    }
+    file.write((const char *)&header, sizeof(header));
+    for(int k = 0; k < number_of_tracers; k++) {
+        const long long id = ID[k];
+        file.write((const char *)&id, sizeof(long long));
+    }
+    file.flush();
+}
+//----------------------------------------------------------------------------------------
+//                              add a record of the states of the tracers
+//----------------------------------------------------------------------------------------
+void TracerRecorder::Record(double Time, const ParticleStore &store, const int *prtl)
+{
+    double *record = buffer + number_of_records*record_length;
+
+    *record++ = Time;
+    for(int k = 0; k < number_of_tracers; k++) {
+        const int n = prtl[k];
+        *record++ = store.R[n][0]; *record++ = store.R[n][1];
+        *record++ = store.U[n][0]; *record++ = store.U[n][1];
+        *record++ = store.rho[n];
+    }
+
+    //the buffer is full
+    if(++number_of_records == TRACER_BUFFER) Flush();
+}
+//----------------------------------------------------------------------------------------
+//                              append the buffered records to the file
+//----------------------------------------------------------------------------------------
+void TracerRecorder::Flush()
+{
+    if(number_of_records == 0 || !file.is_open()) return;
+
+    file.write((const char *)buffer, sizeof(double)*number_of_records*record_length);
+    file.flush();
+    number_of_records = 0;
+}
@@ -0,0 +1,57 @@
+/// \file tracerfile.h
+/// \brief Binary trajectories of tracer particles
+
+#ifndef TRACERFILE_H
+#define TRACERFILE_H
+
+#include <fstream>
+
+class ParticleStore;
+
+/// Binary trajectories of tracer particles
+///
+/// The file is the header, the IDs of the tracers (64 bit integer) and the records,
+/// all little-endian. A record is the time followed by x, y, Ux, Uy and rho of each
+/// tracer, all double, so record k starts at
+/// sizeof(TracerHeader) + 8*number_of_tracers + k*8*(1 + TRACER_STATES*number_of_tracers).
+/// The records are collected in a ring buffer of TRACER_BUFFER records, which is
+/// appended to the file in one block when it is full and when Flush is called,
+/// the memory does not grow with the length of the run.
+struct TracerHeader {
+    char magic[8];              ///TRACER_MAGIC
+    int version;                ///TRACER_VERSION
+    int number_of_tracers;      ///number of tracer particles
+    int number_of_states;       ///TRACER_STATES
+    int reserved;
+};
+
+#define TRACER_MAGIC "SPH-TRC"
+enum { TRACER_VERSION = 1, TRACER_STATES = 5, TRACER_BUFFER = 1024 };
+
+/// Writing the trajectories of tracer particles
+class TracerRecorder {
+
+    std::ofstream file;
+    int number_of_tracers;
+    ///length of a record in doubles
+    int record_length;
+    ///the ring buffer and the number of records in it
+    double *buffer;
+    int number_of_records;
+
+public:
+
+    ///constructor
+    TracerRecorder();
+    ///destructor, the buffered records are written
+    ~TracerRecorder();
+
+    ///create the file for the tracers with the given IDs
+    void Create(const char *file_name, int number_of_tracers, const long *ID);
+    ///add a record of the states of the tracers, the particles prtl[0 ... number_of_tracers - 1]
+    void Record(double Time, const ParticleStore &store, const int *prtl);
+    ///append the buffered records to the file
+    void Flush();
+};
+
+#endif
@@ -50,6 +50,7 @@ Wiener::Wiener(int dimension)
     //creat the Wiener matrix
     randoms = new double*[dimension];
     for(k = 0; k < dimension; k++) randoms[k] = new double[dimension];
+    seed = 0;
 
     sym_trclss = new double*[dimension];
     for(k = 0; k < dimension; k++) sym_trclss[k] = new double[dimension];
@@ -70,6 +71,18 @@ void Wiener::get_wiener(const double sqrtdt)
 
 }
 //----------------------------------------------------------------------------------------
+//                      produce wiener process with Flekkoy's form for a batch of pairs
+//----------------------------------------------------------------------------------------
+void Wiener::get_wiener(long step, int n, const int *org, const int *dest, const double sqrtdt, 
+                        double *random_p, double *random_v) const
+{
+    //each pair only depends on its own counter
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int k = 0; k < n; k++) get_wiener(step, org[k], dest[k], sqrtdt, random_p[k], random_v[k]);
+}
+//----------------------------------------------------------------------------------------
 //      produce wiener vlaue matrix with symmetric tracless part, and the trace/dimension
 //      Please refer to Espanol's paper
 //----------------------------------------------------------------------------------------
@@ -154,6 +167,7 @@ void Wiener::Ranils()
     long int ir = 12211; 
 
     iseed = rand();
+    seed = (unsigned int)iseed;
 
     //  Initial seeds for two random number generators
     idum = iseed + 123456789;
@@ -4,6 +4,8 @@
 #ifndef WIENER_H
 #define WIENER_H
 
+#include <cmath>
+
 ///-----------------------------------------------------------------------
 ///             The class defining Wiener process in two dimensions
 ///-----------------------------------------------------------------------
@@ -24,6 +26,21 @@ class Wiener {
     ///from random numbers uniform distributed in [0, 1]
     void Gaussian(double &y1, double &y2);
 
+    ///counter-based random numbers (Philox4x32-10)
+    ///the 128 bit counter is scrambled by 10 rounds keyed by the seed,
+    ///the result depends only on the counter and the key and not on any state
+    static void Philox(unsigned int counter[4], unsigned int key0, unsigned int key1) {
+        for(int round = 0; round < 10; round++) {
+            const unsigned long long p0 = 0xD2511F53ULL*counter[0], p1 = 0xCD9E8D57ULL*counter[2];
+            const unsigned int c1 = counter[1], c3 = counter[3];
+            counter[0] = (unsigned int)(p1 >> 32) ^ c1 ^ key0;
+            counter[1] = (unsigned int)p1;
+            counter[2] = (unsigned int)(p0 >> 32) ^ c3 ^ key1;
+            counter[3] = (unsigned int)p0;
+            key0 += 0x9E3779B9U; key1 += 0xBB67AE85U;
+        }
+    }
+
 public:
 
     double **sym_trclss;
@@ -43,6 +60,28 @@ public:
     ///wiener process with Flekkoy's form
     void get_wiener(const double sqrtdt);
 
+    ///seed of the counter-based random numbers
+    unsigned int seed;
+
+    ///increments of the Wiener process with Flekkoy's form for the pair (i, j) at a step,
+    ///the same for any order and any thread they are drawn in
+    void get_wiener(long step, int i, int j, const double sqrtdt, double &random_p, double &random_v) const {
+        unsigned int counter[4] = {(unsigned int)i, (unsigned int)j, 
+                                   (unsigned int)step, (unsigned int)((unsigned long long)step >> 32)};
+        Philox(counter, seed, 0);
+        //two uniform numbers in (0, 1) with 53 bits each, Box-Muller transform without rejection
+        const double u1 = ((double)((((unsigned long long)counter[0] << 32) | counter[1]) >> 11) + 0.5)
+            *1.1102230246251565e-16;
+        const double u2 = ((double)((((unsigned long long)counter[2] << 32) | counter[3]) >> 11) + 0.5)
+            *1.1102230246251565e-16;
+        const double r = sqrtdt*sqrt(-2.0*log(u1)), theta = 6.283185307179586*u2;
+        random_p = r*cos(theta);
+        random_v = r*sin(theta);
+    }
+    ///increments of the Wiener process for n pairs at a step
+    void get_wiener(long step, int n, const int *org, const int *dest, const double sqrtdt, 
+                    double *random_p, double *random_v) const;
+
     ///set the random seed
     void Ranils();
 };